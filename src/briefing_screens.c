@@ -37,6 +37,7 @@
 
 #include "animated_counter.h"
 #include "autosave.h"
+#include "game.h"
 #include "loading_screens.h"
 #include "menu_utils.h"
 #include "password.h"
@@ -325,6 +326,9 @@ static GameLoopResult MissionBriefingUpdate(GameLoopData *data, LoopRunner *l)
 		goto bail;
 	}
 
+	// Build the map a stage per frame while the player reads the briefing
+	GameBuildMapStep(&gCampaign, &gMission, &gMap);
+
 	// Update the typewriter effect
 	if (mData->TypewriterCount <= (int)strlen(mData->Description))
 	{
@@ -350,6 +354,7 @@ bail:
 	}
 	else
 	{
+		GameBuildMapCancel();
 		LoopRunnerPop(l);
 	}
 	return UPDATE_RESULT_OK;
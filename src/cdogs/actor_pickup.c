@@ -55,7 +55,7 @@ void PickupPickup(TActor *a, Pickup *p, const bool pickupAll)
 		if (sound != NULL)
 		{
 			e = GameEventNew(GAME_EVENT_SOUND_AT);
-			strcpy(e.u.SoundAt.Sound, sound);
+			e.u.SoundAt.Sound = StrSoundId(sound);
 			e.u.SoundAt.Pos = Vec2ToNet(a->thing.Pos);
 			GameEventsEnqueue(&gGameEvents, e);
 		}
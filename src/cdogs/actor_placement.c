@@ -44,7 +44,10 @@ static struct vec2 PlacePlayerSimple(const Map *map)
 	bool ok = false;
 	for (int j = 0; j < 10000 && !ok; j++)
 	{
-		pos = MapGetRandomPos(map);
+		if (!MapGetRandomSpawnPos(map, PLACEMENT_ACCESS_ANY, &pos))
+		{
+			break;
+		}
 		ok = MapIsPosOKForPlayer(map, pos, false);
 		if (!ok)
 			continue;
@@ -129,7 +132,11 @@ struct vec2 PlaceAwayFromPlayers(
 	// even close to player
 	for (int i = 0; i < 10000 || !giveUp; i++)
 	{
-		const struct vec2 pos = MapGetRandomPos(map);
+		struct vec2 pos;
+		if (!MapGetRandomSpawnPos(map, PLACEMENT_ACCESS_ANY, &pos))
+		{
+			break;
+		}
 		if (MapIsTileAreaClear(map, pos, svec2i(ACTOR_W, ACTOR_H)))
 		{
 			return pos;
@@ -161,13 +168,13 @@ static bool TryPlaceOneAwayFromPlayers(
 
 struct vec2 PlacePrisoner(const Map *map)
 {
-	struct vec2 pos;
+	struct vec2 pos = svec2_zero();
 	do
 	{
-		do
+		if (!MapGetRandomSpawnPos(map, PLACEMENT_ACCESS_LOCKED, &pos))
 		{
-			pos = MapGetRandomPos(map);
-		} while (!MapPosIsInLockedRoom(map, pos));
+			break;
+		}
 	} while (!MapIsTileAreaClear(map, pos, svec2i(ACTOR_W, ACTOR_H)));
 	return pos;
 }
@@ -80,6 +80,13 @@
 #include "triggers.h"
 #include "utils.h"
 
+static ConfigHandle sFootstepsConfig = CONFIG_HANDLE("Sound.Footsteps");
+static ConfigHandle sSwitchMoveStyleConfig =
+	CONFIG_HANDLE("Game.SwitchMoveStyle");
+static ConfigHandle sFireMoveStyleConfig = CONFIG_HANDLE("Game.FireMoveStyle");
+static ConfigHandle sGoreConfig = CONFIG_HANDLE("Graphics.Gore");
+static ConfigHandle sFriendlyFireConfig = CONFIG_HANDLE("Game.FriendlyFire");
+
 #define FOOTSTEP_MAX_ANIM_SPEED 2
 #define REPEL_STRENGTH 0.06f
 #define SLIDE_LOCK 50
@@ -104,6 +111,7 @@
 CArray gPlayerIds;
 
 CArray gActors;
+CArray gActorSprites;
 static unsigned int sActorUIDs = 0;
 
 void ActorSetState(TActor *actor, const ActorAnimation state)
@@ -232,10 +240,12 @@ void UpdateActorState(TActor *actor, int ticks)
 	if (isFootstepFrame)
 	{
 
-		if (ConfigGetBool(&gConfig, "Sound.Footsteps"))
+		if (ConfigHandleBool(&sFootstepsConfig))
 		{
 			GameEvent e = GameEventNew(GAME_EVENT_SOUND_AT);
-			MatGetFootstepSound(c->Class, t, e.u.SoundAt.Sound);
+			char buf[CDOGS_FILENAME_MAX];
+			MatGetFootstepSound(c->Class, t, buf);
+			e.u.SoundAt.Sound = StrSoundId(buf);
 			e.u.SoundAt.Pos = Vec2ToNet(actor->thing.Pos);
 			e.u.SoundAt.Distance = c->Class->FootstepsDistancePlus;
 			GameEventsEnqueue(&gGameEvents, e);
@@ -767,14 +777,16 @@ void InjureActor(TActor *actor, int injury)
 	{
 		actor->stateCounter = 0;
 		GameEvent es = GameEventNew(GAME_EVENT_SOUND_AT);
-		CharacterClassGetSound(
-			ActorGetCharacter(actor)->Class, es.u.SoundAt.Sound, "die");
+		char buf[CDOGS_FILENAME_MAX];
+		CharacterClassGetSound(ActorGetCharacter(actor)->Class, buf, "die");
+		es.u.SoundAt.Sound = StrSoundId(buf);
 		es.u.SoundAt.Pos = Vec2ToNet(actor->thing.Pos);
 		GameEventsEnqueue(&gGameEvents, es);
 		if (actor->PlayerUID >= 0)
 		{
 			es = GameEventNew(GAME_EVENT_SOUND_AT);
-			strcpy(es.u.SoundAt.Sound, "hahaha");
+			static SoundHandle laughSound = SOUND_HANDLE("hahaha");
+			es.u.SoundAt.Sound = SoundHandleId(&laughSound);
 			es.u.SoundAt.Pos = Vec2ToNet(actor->thing.Pos);
 			GameEventsEnqueue(&gGameEvents, es);
 		}
@@ -981,7 +993,8 @@ static void FireWeapon(TActor *a, Weapon *w)
 			if (w->clickLock <= 0)
 			{
 				GameEvent es = GameEventNew(GAME_EVENT_SOUND_AT);
-				strcpy(es.u.SoundAt.Sound, "click");
+				static SoundHandle clickSound = SOUND_HANDLE("click");
+				es.u.SoundAt.Sound = SoundHandleId(&clickSound);
 				es.u.SoundAt.Pos = Vec2ToNet(a->Pos);
 				GameEventsEnqueue(&gGameEvents, es);
 				w->clickLock = SOUND_LOCK_WEAPON_CLICK;
@@ -1017,10 +1030,10 @@ static bool ActorTryChangeDirection(
 {
 	const bool willChangeDirecton =
 		!actor->petrified && CMD_HAS_DIRECTION(cmd) &&
-		(!Button2(cmd) || ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle") !=
+		(!Button2(cmd) || ConfigHandleEnum(&sSwitchMoveStyleConfig) !=
 							  SWITCHMOVE_STRAFE) &&
 		(!Button1(prevCmd) ||
-		 ConfigGetEnum(&gConfig, "Game.FireMoveStyle") != FIREMOVE_STRAFE);
+		 ConfigHandleEnum(&sFireMoveStyleConfig) != FIREMOVE_STRAFE);
 	const direction_e dir = CmdToDirection(cmd);
 	if (willChangeDirecton && dir != actor->direction)
 	{
@@ -1097,7 +1110,7 @@ int CommandActor(TActor *actor, int cmd, int ticks)
 				if (canPickup && sound != NULL)
 				{
 					e = GameEventNew(GAME_EVENT_SOUND_AT);
-					strcpy(e.u.SoundAt.Sound, sound);
+					e.u.SoundAt.Sound = StrSoundId(sound);
 					e.u.SoundAt.Pos = Vec2ToNet(actor->thing.Pos);
 					GameEventsEnqueue(&gGameEvents, e);
 				}
@@ -1208,9 +1221,9 @@ static bool ActorTryMove(TActor *actor, int cmd, int ticks)
 	const bool canMoveWhenShooting =
 		actor->PlayerUID < 0
 			? (actor->flags & FLAGS_MOVE_AND_SHOOT)
-			: (ConfigGetEnum(&gConfig, "Game.FireMoveStyle") !=
+			: (ConfigHandleEnum(&sFireMoveStyleConfig) !=
 				   FIREMOVE_STOP ||
-			   (ConfigGetEnum(&gConfig, "Game.SwitchMoveStyle") ==
+			   (ConfigHandleEnum(&sSwitchMoveStyleConfig) ==
 					SWITCHMOVE_STRAFE &&
 				Button2(cmd)));
 	const bool canMove = !actor->hasShot || canMoveWhenShooting;
@@ -1325,8 +1338,11 @@ void UpdateAllActors(const int ticks)
 	}
 	// Find actors that are on the same team and colliding,
 	// and repel them
+	// Skip dormant AI, which are far from players; they will be repelled
+	// once they wake up
 	if (!gCampaign.IsClient &&
-		gCollisionSystem.allyCollision == ALLYCOLLISION_REPEL)
+		gCollisionSystem.allyCollision == ALLYCOLLISION_REPEL &&
+		!(actor->aiContext != NULL && actor->aiContext->IsDormant))
 	{
 		const CollisionParams params = {
 			THING_IMPASSABLE, COLLISIONTEAM_NONE, IsPVP(gCampaign.Entry.Mode),
@@ -1524,7 +1540,7 @@ static void CheckManualPilot(TActor *a, const CollisionParams params)
 static void ActorDie(TActor *actor)
 {
 	// Add corpse
-	if (ConfigGetEnum(&gConfig, "Graphics.Gore") != GORE_NONE)
+	if (ConfigHandleEnum(&sGoreConfig) != GORE_NONE)
 	{
 		const Character *c = ActorGetCharacter(actor);
 		GameEvent ea = GameEventNew(GAME_EVENT_MAP_OBJECT_ADD);
@@ -1701,6 +1717,7 @@ void ActorsInit(void)
 {
 	CArrayInit(&gActors, sizeof(TActor));
 	CArrayReserve(&gActors, 64);
+	CArrayInit(&gActorSprites, sizeof(ActorSprites));
 	sActorUIDs = 0;
 }
 void ActorsTerminate(void)
@@ -1711,6 +1728,7 @@ void ActorsTerminate(void)
 	ActorDestroy(a);
 	CA_FOREACH_END()
 	CArrayTerminate(&gActors);
+	CArrayTerminate(&gActorSprites);
 }
 int ActorsGetNextUID(void)
 {
@@ -1748,6 +1766,14 @@ TActor *ActorAdd(NActorAdd aa)
 	}
 	TActor *actor = CArrayGet(&gActors, id);
 	memset(actor, 0, sizeof *actor);
+	// Reset the drawing cache for this slot
+	ActorSprites noSprites;
+	memset(&noSprites, 0, sizeof noSprites);
+	while (id >= (int)gActorSprites.size)
+	{
+		CArrayPushBack(&gActorSprites, &noSprites);
+	}
+	CArraySet(&gActorSprites, id, &noSprites);
 	actor->uid = aa.UID;
 	LOG(LM_ACTOR, LL_DEBUG, "add actor uid(%d) playerUID(%d)", actor->uid,
 		aa.PlayerUID);
@@ -2295,7 +2321,7 @@ bool ActorIsInvulnerable(
 		const bool isTargetGood =
 			actor->PlayerUID >= 0 || (actor->flags & FLAGS_GOOD_GUY);
 		// Friendly fire (NPCs)
-		if (!IsPVP(mode) && !ConfigGetBool(&gConfig, "Game.FriendlyFire") &&
+		if (!IsPVP(mode) && !ConfigHandleBool(&sFriendlyFireConfig) &&
 			isGood && isTargetGood)
 		{
 			return true;
@@ -2317,7 +2343,7 @@ bool ActorIsInvulnerable(
 static void ActorAddBloodSplatters(
 	TActor *a, const int power, const float mass, const struct vec2 hitVector)
 {
-	const GoreAmount ga = ConfigGetEnum(&gConfig, "Graphics.Gore");
+	const GoreAmount ga = ConfigHandleEnum(&sGoreConfig);
 	if (ga == GORE_NONE)
 		return;
 	const color_t bloodColor = ActorGetCharacter(a)->Class->BloodColor;
@@ -97,6 +97,27 @@ typedef enum
 	ACTORACTION_EXITING
 } ActorAction;
 
+// Character sprites resolved for drawing an actor, so that they don't need
+// to be looked up by name every frame.
+// Valid while the key fields and the masked sprite generation match.
+typedef struct
+{
+	bool IsValid;
+	int Generation;
+	const CharacterClass *Class;
+	const char *HeadPartNames[HEAD_PART_COUNT];
+	CharColors Colors;
+	const WeaponClass *Gun;
+
+	// Masked sprites, touched on use to keep them from being evicted
+	NamedSprites *Head;
+	NamedSprites *HeadParts[HEAD_PART_COUNT];
+	NamedSprites *Body[2][2]; // [walking][firing]
+	NamedSprites *Legs[2];	  // [walking]
+	NamedSprites *Guns[MAX_BARRELS];
+	const NamedSprites *Death;
+} ActorSprites;
+
 typedef struct Actor
 {
 	struct vec2 Pos;
@@ -200,6 +221,8 @@ typedef struct Actor
 // actors are added and the array must be resized.
 // Therefore do not hold actor pointers and reuse.
 extern CArray gActors; // of TActor
+// Drawing cache, indexed like gActors; not part of the actors' state
+extern CArray gActorSprites; // of ActorSprites
 
 void ActorSetState(TActor *actor, const ActorAnimation state);
 void UpdateActorState(TActor *actor, int ticks);
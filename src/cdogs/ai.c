@@ -68,9 +68,15 @@
 
 #define AI_WAKE_SOUND_RANGE (8 * TILE_WIDTH)
 #define AI_WAKE_SOUND_RANGE_INDIRECT (4 * TILE_WIDTH)
+// Dormant AI only check whether to wake once every this many AI updates
+#define AI_DORMANT_UPDATE_INTERVAL 8
 
 static int gBaddieCount = 0;
 static bool sAreGoodGuysPresent = false;
+static int sAIUpdateCount = 0;
+static ConfigHandle sAIUpdateRadiusConfig =
+	CONFIG_HANDLE("Game.AIUpdateRadius");
+static ConfigHandle sSightRangeConfig = CONFIG_HANDLE("Game.SightRange");
 
 static bool IsFacingPlayer(TActor *actor, direction_e d)
 {
@@ -302,6 +308,19 @@ static bool IsAIEnabled(const TActor *a)
 		   !ActorGetCharacter(a)->Class->Vehicle;
 }
 
+// Dormant actors are sleeping and too far from any player to see them, so
+// they can only be woken by sound, damage or seeing someone being attacked.
+// The first two wake them immediately; the last is checked at a reduced rate.
+static bool IsAIDormant(const TActor *a, const float radius)
+{
+	if (!(a->flags & FLAGS_SLEEPING) || (a->flags & FLAGS_WAKING) ||
+		a->aiContext->Delay > 0)
+	{
+		return false;
+	}
+	return !IsCloseToPlayer(a->Pos, radius);
+}
+
 static int Follow(TActor *a);
 static int GetCmd(TActor *actor, const int delayModifier, const int rollLimit);
 int AICommand(const int ticks)
@@ -334,19 +353,34 @@ int AICommand(const int ticks)
 		break;
 	}
 
+	// Never let dormant actors miss a player they could have seen
+	const float dormantRadius =
+		(float)MAX(
+			ConfigHandleInt(&sAIUpdateRadiusConfig),
+			ConfigHandleInt(&sSightRangeConfig)) *
+		TILE_WIDTH;
+	sAIUpdateCount++;
+
 	CA_FOREACH(TActor, actor, gActors)
 	if (!IsAIEnabled(actor))
 	{
 		continue;
 	}
 	int cmd = 0;
+	actor->aiContext->IsDormant = false;
 	if (!(actor->flags & FLAGS_PRISONER))
 	{
 		if (actor->flags & (FLAGS_VICTIM | FLAGS_GOOD_GUY))
 		{
 			sAreGoodGuysPresent = true;
 		}
-		cmd = GetCmd(actor, delayModifier, rollLimit);
+		actor->aiContext->IsDormant = IsAIDormant(actor, dormantRadius);
+		// Stagger dormant updates across actors
+		if (!actor->aiContext->IsDormant ||
+			(sAIUpdateCount + _ca_index) % AI_DORMANT_UPDATE_INTERVAL == 0)
+		{
+			cmd = GetCmd(actor, delayModifier, rollLimit);
+		}
 		actor->aiContext->Delay = MAX(0, actor->aiContext->Delay - ticks);
 	}
 	actor->aiContext->LastCmd = CommandActor(actor, cmd, ticks);
@@ -504,6 +538,7 @@ void AIWake(TActor *a, const int delayModifier)
 		return;
 	a->flags &= ~FLAGS_SLEEPING;
 	a->flags |= FLAGS_WAKING;
+	a->aiContext->IsDormant = false;
 	ActorSetAIState(a, AI_STATE_NONE);
 	const CharBot *bot = ActorGetCharacter(a)->bot;
 	if (bot == NULL)
@@ -514,8 +549,9 @@ void AIWake(TActor *a, const int delayModifier)
 	if (!(a->flags & FLAGS_SEETHROUGH))
 	{
 		GameEvent es = GameEventNew(GAME_EVENT_SOUND_AT);
-		CharacterClassGetSound(
-			ActorGetCharacter(a)->Class, es.u.SoundAt.Sound, "alert");
+		char buf[CDOGS_FILENAME_MAX];
+		CharacterClassGetSound(ActorGetCharacter(a)->Class, buf, "alert");
+		es.u.SoundAt.Sound = StrSoundId(buf);
 		es.u.SoundAt.Pos = Vec2ToNet(a->thing.Pos);
 		GameEventsEnqueue(&gGameEvents, es);
 	}
@@ -105,6 +105,8 @@ typedef struct
 	int EnemyId;
 	double GunRangeScalar;
 	int OnGunId;
+	// Sleeping and far from all players; updated at a reduced rate
+	bool IsDormant;
 } AIContext;
 
 AIContext *AIContextNew(void);
@@ -58,6 +58,8 @@
 #include "path_cache.h"
 #include "weapon.h"
 
+static ConfigHandle sSightRangeConfig = CONFIG_HANDLE("Game.SightRange");
+
 TActor *AIGetClosestPlayer(const struct vec2 pos)
 {
 	float minDistance2 = -1;
@@ -330,7 +332,7 @@ bool AIHasClearView(
 bool AICanSee(const TActor *a, const struct vec2 target, const direction_e d)
 {
 	const int sightRange =
-		ConfigGetInt(&gConfig, "Game.SightRange") * TILE_WIDTH;
+		ConfigHandleInt(&sSightRangeConfig) * TILE_WIDTH;
 	if ((a->flags & FLAGS_ALL_SEEING) || AIIsFacing(a, target, d))
 	{
 		return AIHasClearView(a, target, sightRange * 2 / 3);
@@ -169,6 +169,22 @@ typedef struct
 static HitResult HitItem(
 	TMobileObject *obj, const struct vec2 pos, const struct vec2 vel,
 	const bool multipleHits);
+// Ticks between searches for the closest target for homing bullets
+#define SEEK_RETARGET_TICKS 8
+static const TActor *GetSeekTarget(const TMobileObject *obj)
+{
+	if (obj->targetId < 0 || obj->targetId >= (int)gActors.size)
+	{
+		return NULL;
+	}
+	const TActor *a = CArrayGet(&gActors, obj->targetId);
+	if (!a->isInUse || a->uid != obj->targetUID || a->dead ||
+		(a->flags & (FLAGS_INVULNERABLE | FLAGS_PENALTY)))
+	{
+		return NULL;
+	}
+	return a;
+}
 bool BulletUpdate(struct MobileObject *obj, const int ticks)
 {
 	ThingUpdate(&obj->thing, ticks);
@@ -197,14 +213,22 @@ bool BulletUpdate(struct MobileObject *obj, const int ticks)
 
 	if (obj->bulletClass->SeekFactor > 0)
 	{
-		// Find the closest target to this bullet and steer towards it
-		const TActor *owner = ActorGetByUID(obj->ActorUID);
-		if (owner == NULL)
+		// Steer towards the current target, finding the closest one if the
+		// target is gone or it is time to search again
+		obj->targetTicks -= ticks;
+		const TActor *target = obj->targetTicks > 0 ? GetSeekTarget(obj) : NULL;
+		if (target == NULL)
 		{
-			return false;
+			const TActor *owner = ActorGetByUID(obj->ActorUID);
+			if (owner == NULL)
+			{
+				return false;
+			}
+			target = AIGetClosestEnemy(obj->thing.Pos, owner, obj->flags);
+			obj->targetId = target ? target->thing.id : -1;
+			obj->targetUID = target ? target->uid : -1;
+			obj->targetTicks = SEEK_RETARGET_TICKS;
 		}
-		const TActor *target =
-			AIGetClosestEnemy(obj->thing.Pos, owner, obj->flags);
 		if (target && !target->dead)
 		{
 			for (int i = 0; i < ticks; i++)
@@ -342,7 +366,8 @@ bool BulletUpdate(struct MobileObject *obj, const int ticks)
 					return false;
 				}
 				GameEvent es = GameEventNew(GAME_EVENT_SOUND_AT);
-				strcpy(es.u.SoundAt.Sound, obj->bulletClass->Hit.Wall.Sound);
+				es.u.SoundAt.Sound =
+					StrSoundId(obj->bulletClass->Hit.Wall.Sound);
 				es.u.SoundAt.Pos = Vec2ToNet(pos);
 				GameEventsEnqueue(&gGameEvents, es);
 			}
@@ -497,9 +522,9 @@ static bool HitItemFunc(
 	Thing *ti, void *data, const struct vec2 colA, const struct vec2 colB,
 	const struct vec2 normal);
 static bool CheckWall(const struct vec2i tilePos);
-static bool HitWallFunc(
-	const struct vec2i tilePos, void *data, const struct vec2 col,
-	const struct vec2 normal);
+static void SetClosestCollision(
+	HitItemData *data, const struct vec2 col, const struct vec2 normal,
+	const HitType ht, Thing *target, const struct vec2i tilePos);
 static void OnHit(HitItemData *data, Thing *target);
 static HitResult HitItem(
 	TMobileObject *obj, const struct vec2 pos, const struct vec2 vel,
@@ -516,9 +541,22 @@ static HitResult HitItem(
 	const CollisionParams params = {
 		THING_CAN_BE_SHOT, COLLISIONTEAM_NONE, IsPVP(gCampaign.Entry.Mode),
 		false};
-	OverlapThings(
-		&obj->thing, pos, vel, obj->thing.size, params, HitItemFunc, &data,
-		CheckWall, HitWallFunc, &data);
+	// Bullets are zero-size against walls, so raycast through the tiles
+	struct vec2i wallTile;
+	struct vec2 wallCol, wallNormal;
+	if (RaycastWalls(pos, vel, CheckWall, &wallTile, &wallCol, &wallNormal))
+	{
+		SetClosestCollision(
+			&data, wallCol, wallNormal, HIT_WALL, NULL, wallTile);
+	}
+	// Most bullets are in open space; skip the full things check for them
+	if (OverlapThingsMayHit(
+			&obj->thing, pos, vel, obj->thing.size, params))
+	{
+		OverlapThings(
+			&obj->thing, pos, vel, obj->thing.size, params, HitItemFunc, &data,
+			NULL, NULL, NULL);
+	}
 	if (!multipleHits && data.ColPosDist2 >= 0)
 	{
 		if (data.HitType == HIT_OBJECT || data.HitType == HIT_FLESH)
@@ -531,9 +569,6 @@ static HitResult HitItem(
 }
 static HitType GetHitType(
 	const Thing *ti, const TMobileObject *bullet, int *targetUID);
-static void SetClosestCollision(
-	HitItemData *data, const struct vec2 col, const struct vec2 normal,
-	const HitType ht, Thing *target, const struct vec2i tilePos);
 static bool HitItemFunc(
 	Thing *ti, void *data, const struct vec2 colA, const struct vec2 colB,
 	const struct vec2 normal)
@@ -602,16 +637,6 @@ static bool CheckWall(const struct vec2i tilePos)
 	const Tile *t = MapGetTile(&gMap, tilePos);
 	return t == NULL || TileIsShootable(t);
 }
-static bool HitWallFunc(
-	const struct vec2i tilePos, void *data, const struct vec2 col,
-	const struct vec2 normal)
-{
-	HitItemData *hData = data;
-
-	SetClosestCollision(hData, col, normal, HIT_WALL, NULL, tilePos);
-
-	return true;
-}
 static void SetClosestCollision(
 	HitItemData *data, const struct vec2 col, const struct vec2 normal,
 	const HitType ht, Thing *target, const struct vec2i tilePos)
@@ -650,6 +675,11 @@ static void OnHit(HitItemData *data, Thing *target)
 	{
 		target->SoundLock += SOUND_LOCK_THING;
 	}
+	if (target->kind == KIND_OBJECT)
+	{
+		// Wake so that the sound lock wears off
+		ObjWake(CArrayGet(&gObjs, target->id));
+	}
 }
 
 #define VERSION 5
@@ -1075,6 +1105,8 @@ void BulletAdd(const NAddBullet add)
 	}
 
 	obj->ActorUID = add.ActorUID;
+	obj->targetId = -1;
+	obj->targetUID = -1;
 	obj->range =
 		RAND_INT(obj->bulletClass->RangeLow, obj->bulletClass->RangeHigh);
 
@@ -1164,7 +1196,7 @@ void PlayHitSound(const BulletClass *b, const HitType t, const struct vec2 pos)
 	{
 		return;
 	}
-	strcpy(es.u.SoundAt.Sound, sound);
+	es.u.SoundAt.Sound = StrSoundId(sound);
 	es.u.SoundAt.Pos = Vec2ToNet(pos);
 	GameEventsEnqueue(&gGameEvents, es);
 }
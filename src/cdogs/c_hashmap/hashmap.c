@@ -1,33 +1,72 @@
 /*
  * Generic map implementation.
+ *
+ * Open addressing with Robin Hood probing. Elements live in a dense array in
+ * insertion order; the probe table only holds a 32-bit hash fragment and an
+ * index into that array. Full 64-bit hashes are stored with each element so
+ * that growing never rehashes key strings, and iteration order does not
+ * depend on the table size.
  */
 #include "hashmap.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define INITIAL_SIZE (256)
-#define MAX_CHAIN_LENGTH (8)
+#define INITIAL_SIZE (16)
+// Grow when the probe table is more than 7/8 full
+#define MAX_LOAD_NUM (7)
+#define MAX_LOAD_DEN (8)
 
-/* We need to keep keys and values */
+/* We need to keep keys and values; key is NULL for removed elements */
 typedef struct _hashmap_element
 {
+	uint64_t hash;
 	char *key;
-	bool in_use;
 	any_t data;
 } hashmap_element;
 
-/* A hashmap has some maximum size and current size,
- * as well as the data to hold. */
+/* Probe table slot; index is 1-based so that 0 means empty */
+typedef struct
+{
+	uint32_t hash;
+	uint32_t index;
+} hashmap_slot;
+
 struct hashmap_map
 {
-	int table_size;
-	int size;
+	// Probe table, power-of-two sized
+	hashmap_slot *slots;
+	uint32_t mask;
+	// Elements in insertion order, including removed ones
 	hashmap_element *data;
+	int data_size;
+	int data_cap;
+	// Number of live elements
+	int size;
 };
 
+static int hashmap_alloc(map_t m, const int table_size, const int data_cap)
+{
+	m->slots = (hashmap_slot *)calloc(table_size, sizeof(hashmap_slot));
+	m->data = (hashmap_element *)malloc(data_cap * sizeof(hashmap_element));
+	if (!m->slots || !m->data)
+	{
+		free(m->slots);
+		free(m->data);
+		m->slots = NULL;
+		m->data = NULL;
+		return MAP_OMEM;
+	}
+	m->mask = (uint32_t)table_size - 1;
+	m->data_size = 0;
+	m->data_cap = data_cap;
+	m->size = 0;
+	return MAP_OK;
+}
+
 /*
  * Return an empty hashmap, or NULL on failure.
  */
@@ -35,293 +74,247 @@ map_t hashmap_new(void)
 {
 	map_t m = malloc(sizeof(struct hashmap_map));
 	if (!m)
-		goto err;
-
-	m->table_size = 0;
-	m->data = (hashmap_element *)calloc(INITIAL_SIZE, sizeof(hashmap_element));
-	if (!m->data)
-		goto err;
-
-	m->table_size = INITIAL_SIZE;
-	m->size = 0;
-
+		return NULL;
+	if (hashmap_alloc(m, INITIAL_SIZE, INITIAL_SIZE) != MAP_OK)
+	{
+		free(m);
+		return NULL;
+	}
 	return m;
-err:
-	if (m)
-		hashmap_free(m);
-	return NULL;
 }
 
-typedef struct
-{
-	map_t dst;
-	const map_t src;
-	any_t (*callback)(any_t);
-} HashmapCopyData;
-static int copy_key(any_t data, any_t key);
 map_t hashmap_copy(const map_t in, any_t (*callback)(any_t))
 {
 	map_t m = hashmap_new();
-	HashmapCopyData data = {m, in, callback};
-	if (hashmap_iterate_keys(in, copy_key, (any_t)&data) != MAP_OK)
+	if (m == NULL)
+		return NULL;
+	for (int i = 0; i < in->data_size; i++)
 	{
-		hashmap_free(m);
-		m = NULL;
+		const hashmap_element *e = &in->data[i];
+		if (e->key == NULL)
+			continue;
+		any_t copy = e->data;
+		if (callback != NULL)
+		{
+			copy = callback(e->data);
+		}
+		if (hashmap_put(m, e->key, copy) != MAP_OK)
+		{
+			hashmap_free(m);
+			return NULL;
+		}
 	}
 	return m;
 }
-static int copy_key(any_t data, any_t key)
+
+/*
+ * String hash in the style of wyhash: 64-bit multiply-and-fold mixing,
+ * reading the key 8 bytes at a time.
+ */
+#define HASH_S0 0xa0761d6478bd642fULL
+#define HASH_S1 0xe7037ed1a0b428dbULL
+
+static uint64_t hash_mix(const uint64_t a, const uint64_t b)
 {
-	HashmapCopyData *hData = (HashmapCopyData *)data;
-	any_t value;
-	int error = hashmap_get(hData->src, (char *)key, &value);
-	if (error != MAP_OK)
-	{
-		return error;
-	}
-    any_t copy = value;
-    if (hData->callback != NULL)
-    {
-        copy = hData->callback(value);
-    }
-	return hashmap_put(hData->dst, key, copy);
+#ifdef __SIZEOF_INT128__
+	const __uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+	const uint64_t ha = a >> 32, hb = b >> 32;
+	const uint64_t la = (uint32_t)a, lb = (uint32_t)b;
+	const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	const uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	const uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	return lo ^ hi;
+#endif
 }
-
-/* The implementation here was originally done by Gary S. Brown.  I have
-   borrowed the tables directly, and made some minor changes to the
-   crc32-function (including changing the interface). //ylo */
-
-/* ============================================================= */
-/*  COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or       */
-/*  code or tables extracted from it, as desired without restriction.     */
-/*                                                                        */
-/*  First, the polynomial itself and its table of feedback terms.  The    */
-/*  polynomial is                                                         */
-/*  X^32+X^26+X^23+X^22+X^16+X^12+X^11+X^10+X^8+X^7+X^5+X^4+X^2+X^1+X^0   */
-/*                                                                        */
-/*  Note that we take it "backwards" and put the highest-order term in    */
-/*  the lowest-order bit.  The X^32 term is "implied"; the LSB is the     */
-/*  X^31 term, etc.  The X^0 term (usually shown as "+1") results in      */
-/*  the MSB being 1.                                                      */
-/*                                                                        */
-/*  Note that the usual hardware shift register implementation, which     */
-/*  is what we're using (we're merely optimizing it by doing eight-bit    */
-/*  chunks at a time) shifts bits into the lowest-order term.  In our     */
-/*  implementation, that means shifting towards the right.  Why do we     */
-/*  do it this way?  Because the calculated CRC must be transmitted in    */
-/*  order from highest-order term to lowest-order term.  UARTs transmit   */
-/*  characters in order from LSB to MSB.  By storing the CRC this way,    */
-/*  we hand it to the UART in the order low-byte to high-byte; the UART   */
-/*  sends each low-bit to hight-bit; and the result is transmission bit   */
-/*  by bit from highest- to lowest-order term without requiring any bit   */
-/*  shuffling on our part.  Reception works similarly.                    */
-/*                                                                        */
-/*  The feedback terms table consists of 256, 32-bit entries.  Notes:     */
-/*                                                                        */
-/*      The table can be generated at runtime if desired; code to do so   */
-/*      is shown later.  It might not be obvious, but the feedback        */
-/*      terms simply represent the results of eight shift/xor opera-      */
-/*      tions for all combinations of data and CRC register values.       */
-/*                                                                        */
-/*      The values must be right-shifted by eight bits by the "updcrc"    */
-/*      logic; the shift must be unsigned (bring in zeroes).  On some     */
-/*      hardware you could probably optimize the shift in assembler by    */
-/*      using byte-swap instructions.                                     */
-/*      polynomial $edb88320                                              */
-/*                                                                        */
-/*  --------------------------------------------------------------------  */
-
-static unsigned long crc32_tab[] = {
-	0x00000000L, 0x77073096L, 0xee0e612cL, 0x990951baL, 0x076dc419L,
-	0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0x0edb8832L, 0x79dcb8a4L,
-	0xe0d5e91eL, 0x97d2d988L, 0x09b64c2bL, 0x7eb17cbdL, 0xe7b82d07L,
-	0x90bf1d91L, 0x1db71064L, 0x6ab020f2L, 0xf3b97148L, 0x84be41deL,
-	0x1adad47dL, 0x6ddde4ebL, 0xf4d4b551L, 0x83d385c7L, 0x136c9856L,
-	0x646ba8c0L, 0xfd62f97aL, 0x8a65c9ecL, 0x14015c4fL, 0x63066cd9L,
-	0xfa0f3d63L, 0x8d080df5L, 0x3b6e20c8L, 0x4c69105eL, 0xd56041e4L,
-	0xa2677172L, 0x3c03e4d1L, 0x4b04d447L, 0xd20d85fdL, 0xa50ab56bL,
-	0x35b5a8faL, 0x42b2986cL, 0xdbbbc9d6L, 0xacbcf940L, 0x32d86ce3L,
-	0x45df5c75L, 0xdcd60dcfL, 0xabd13d59L, 0x26d930acL, 0x51de003aL,
-	0xc8d75180L, 0xbfd06116L, 0x21b4f4b5L, 0x56b3c423L, 0xcfba9599L,
-	0xb8bda50fL, 0x2802b89eL, 0x5f058808L, 0xc60cd9b2L, 0xb10be924L,
-	0x2f6f7c87L, 0x58684c11L, 0xc1611dabL, 0xb6662d3dL, 0x76dc4190L,
-	0x01db7106L, 0x98d220bcL, 0xefd5102aL, 0x71b18589L, 0x06b6b51fL,
-	0x9fbfe4a5L, 0xe8b8d433L, 0x7807c9a2L, 0x0f00f934L, 0x9609a88eL,
-	0xe10e9818L, 0x7f6a0dbbL, 0x086d3d2dL, 0x91646c97L, 0xe6635c01L,
-	0x6b6b51f4L, 0x1c6c6162L, 0x856530d8L, 0xf262004eL, 0x6c0695edL,
-	0x1b01a57bL, 0x8208f4c1L, 0xf50fc457L, 0x65b0d9c6L, 0x12b7e950L,
-	0x8bbeb8eaL, 0xfcb9887cL, 0x62dd1ddfL, 0x15da2d49L, 0x8cd37cf3L,
-	0xfbd44c65L, 0x4db26158L, 0x3ab551ceL, 0xa3bc0074L, 0xd4bb30e2L,
-	0x4adfa541L, 0x3dd895d7L, 0xa4d1c46dL, 0xd3d6f4fbL, 0x4369e96aL,
-	0x346ed9fcL, 0xad678846L, 0xda60b8d0L, 0x44042d73L, 0x33031de5L,
-	0xaa0a4c5fL, 0xdd0d7cc9L, 0x5005713cL, 0x270241aaL, 0xbe0b1010L,
-	0xc90c2086L, 0x5768b525L, 0x206f85b3L, 0xb966d409L, 0xce61e49fL,
-	0x5edef90eL, 0x29d9c998L, 0xb0d09822L, 0xc7d7a8b4L, 0x59b33d17L,
-	0x2eb40d81L, 0xb7bd5c3bL, 0xc0ba6cadL, 0xedb88320L, 0x9abfb3b6L,
-	0x03b6e20cL, 0x74b1d29aL, 0xead54739L, 0x9dd277afL, 0x04db2615L,
-	0x73dc1683L, 0xe3630b12L, 0x94643b84L, 0x0d6d6a3eL, 0x7a6a5aa8L,
-	0xe40ecf0bL, 0x9309ff9dL, 0x0a00ae27L, 0x7d079eb1L, 0xf00f9344L,
-	0x8708a3d2L, 0x1e01f268L, 0x6906c2feL, 0xf762575dL, 0x806567cbL,
-	0x196c3671L, 0x6e6b06e7L, 0xfed41b76L, 0x89d32be0L, 0x10da7a5aL,
-	0x67dd4accL, 0xf9b9df6fL, 0x8ebeeff9L, 0x17b7be43L, 0x60b08ed5L,
-	0xd6d6a3e8L, 0xa1d1937eL, 0x38d8c2c4L, 0x4fdff252L, 0xd1bb67f1L,
-	0xa6bc5767L, 0x3fb506ddL, 0x48b2364bL, 0xd80d2bdaL, 0xaf0a1b4cL,
-	0x36034af6L, 0x41047a60L, 0xdf60efc3L, 0xa867df55L, 0x316e8eefL,
-	0x4669be79L, 0xcb61b38cL, 0xbc66831aL, 0x256fd2a0L, 0x5268e236L,
-	0xcc0c7795L, 0xbb0b4703L, 0x220216b9L, 0x5505262fL, 0xc5ba3bbeL,
-	0xb2bd0b28L, 0x2bb45a92L, 0x5cb36a04L, 0xc2d7ffa7L, 0xb5d0cf31L,
-	0x2cd99e8bL, 0x5bdeae1dL, 0x9b64c2b0L, 0xec63f226L, 0x756aa39cL,
-	0x026d930aL, 0x9c0906a9L, 0xeb0e363fL, 0x72076785L, 0x05005713L,
-	0x95bf4a82L, 0xe2b87a14L, 0x7bb12baeL, 0x0cb61b38L, 0x92d28e9bL,
-	0xe5d5be0dL, 0x7cdcefb7L, 0x0bdbdf21L, 0x86d3d2d4L, 0xf1d4e242L,
-	0x68ddb3f8L, 0x1fda836eL, 0x81be16cdL, 0xf6b9265bL, 0x6fb077e1L,
-	0x18b74777L, 0x88085ae6L, 0xff0f6a70L, 0x66063bcaL, 0x11010b5cL,
-	0x8f659effL, 0xf862ae69L, 0x616bffd3L, 0x166ccf45L, 0xa00ae278L,
-	0xd70dd2eeL, 0x4e048354L, 0x3903b3c2L, 0xa7672661L, 0xd06016f7L,
-	0x4969474dL, 0x3e6e77dbL, 0xaed16a4aL, 0xd9d65adcL, 0x40df0b66L,
-	0x37d83bf0L, 0xa9bcae53L, 0xdebb9ec5L, 0x47b2cf7fL, 0x30b5ffe9L,
-	0xbdbdf21cL, 0xcabac28aL, 0x53b39330L, 0x24b4a3a6L, 0xbad03605L,
-	0xcdd70693L, 0x54de5729L, 0x23d967bfL, 0xb3667a2eL, 0xc4614ab8L,
-	0x5d681b02L, 0x2a6f2b94L, 0xb40bbe37L, 0xc30c8ea1L, 0x5a05df1bL,
-	0x2d02ef8dL};
-
-/* Return a 32-bit CRC of the contents of the buffer. */
-
-static unsigned long crc32(const unsigned char *s, size_t len)
+static uint64_t hash_r8(const unsigned char *p)
 {
-	unsigned int i;
-	unsigned long crc32val;
-
-	crc32val = 0;
-	for (i = 0; i < len; i++)
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return v;
+}
+static uint64_t hash_r4(const unsigned char *p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+static uint64_t hash_r3(const unsigned char *p, const size_t len)
+{
+	return ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) |
+		   p[len - 1];
+}
+static uint64_t hashmap_hash_str(const char *key, const size_t len)
+{
+	const unsigned char *p = (const unsigned char *)key;
+	uint64_t seed = hash_mix(HASH_S0, HASH_S1);
+	uint64_t a, b;
+	if (len <= 16)
 	{
-		crc32val = crc32_tab[(crc32val ^ s[i]) & 0xff] ^ (crc32val >> 8);
+		if (len >= 4)
+		{
+			const size_t off = (len >> 3) << 2;
+			a = (hash_r4(p) << 32) | hash_r4(p + off);
+			b = (hash_r4(p + len - 4) << 32) | hash_r4(p + len - 4 - off);
+		}
+		else if (len > 0)
+		{
+			a = hash_r3(p, len);
+			b = 0;
+		}
+		else
+		{
+			a = b = 0;
+		}
 	}
-	return crc32val;
+	else
+	{
+		size_t i = len;
+		while (i > 16)
+		{
+			seed = hash_mix(hash_r8(p) ^ HASH_S1, hash_r8(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = hash_r8(p + i - 16);
+		b = hash_r8(p + i - 8);
+	}
+	return hash_mix(HASH_S1 ^ len, hash_mix(a ^ HASH_S1, b ^ seed));
 }
 
-/*
- * Hashing function for a string
- */
-static unsigned int hashmap_hash_int(const map_t m, const char *keystring)
+static uint32_t slot_distance(const map_t m, const uint32_t pos, const uint32_t hash)
 {
-
-	unsigned long key =
-		crc32((const unsigned char *)keystring, strlen(keystring));
-
-	/* Robert Jenkins' 32 bit Mix Function */
-	key += (key << 12);
-	key ^= (key >> 22);
-	key += (key << 4);
-	key ^= (key >> 9);
-	key += (key << 10);
-	key ^= (key >> 2);
-	key += (key << 7);
-	key ^= (key >> 12);
-
-	/* Knuth's Multiplicative Method */
-	key = (key >> 3) * 2654435761;
-
-	return key % m->table_size;
+	return (pos - hash) & m->mask;
 }
 
 /*
- * Return the integer of the location in data
- * to store the point to the item, or MAP_FULL.
+ * Return the probe table position of the key, or -1 if missing.
  */
-static int hashmap_hash(map_t m, const char *key)
+static int hashmap_find(const map_t m, const char *key, const uint64_t hash)
 {
-	int curr;
-	int i;
-
-	/* If full, return immediately */
-	if (m->size >= (m->table_size / 2))
-		return MAP_FULL;
-
-	/* Find the best index */
-	curr = hashmap_hash_int(m, key);
-
-	/* Linear probing */
-	for (i = 0; i < MAX_CHAIN_LENGTH; i++)
+	const uint32_t h = (uint32_t)hash;
+	uint32_t pos = h & m->mask;
+	for (uint32_t dist = 0;; dist++)
 	{
-		if (m->data[curr].in_use == 0)
-			return curr;
-
-		if (m->data[curr].in_use == 1 && (strcmp(m->data[curr].key, key) == 0))
-			return curr;
-
-		curr = (curr + 1) % m->table_size;
+		const hashmap_slot s = m->slots[pos];
+		// Robin Hood invariant: we would have been placed before any
+		// element closer to its home than we are
+		if (s.index == 0 || slot_distance(m, pos, s.hash) < dist)
+			return -1;
+		if (s.hash == h && strcmp(m->data[s.index - 1].key, key) == 0)
+			return (int)pos;
+		pos = (pos + 1) & m->mask;
 	}
+}
 
-	return MAP_FULL;
+static void hashmap_insert_slot(map_t m, hashmap_slot s)
+{
+	uint32_t pos = s.hash & m->mask;
+	for (uint32_t dist = 0;; dist++)
+	{
+		hashmap_slot *cur = &m->slots[pos];
+		if (cur->index == 0)
+		{
+			*cur = s;
+			return;
+		}
+		// Take from the rich: displace elements closer to their home
+		const uint32_t curDist = slot_distance(m, pos, cur->hash);
+		if (curDist < dist)
+		{
+			const hashmap_slot tmp = *cur;
+			*cur = s;
+			s = tmp;
+			dist = curDist;
+		}
+		pos = (pos + 1) & m->mask;
+	}
 }
 
 /*
- * Doubles the size of the hashmap, and rehashes all the elements
+ * Rebuild the probe table at the new size, compacting removed elements.
+ * Keys are not rehashed.
  */
-static int hashmap_rehash(map_t m)
+static int hashmap_rehash(map_t m, const int table_size)
 {
-	int i;
-	int old_size;
-	hashmap_element *curr;
-
-	/* Setup the new elements */
-	hashmap_element *temp =
-		(hashmap_element *)calloc(2 * m->table_size, sizeof(hashmap_element));
-	if (!temp)
+	hashmap_slot *slots =
+		(hashmap_slot *)calloc(table_size, sizeof(hashmap_slot));
+	if (!slots)
 		return MAP_OMEM;
+	free(m->slots);
+	m->slots = slots;
+	m->mask = (uint32_t)table_size - 1;
 
-	/* Update the array */
-	curr = m->data;
-	m->data = temp;
-
-	/* Update the size */
-	old_size = m->table_size;
-	m->table_size = 2 * m->table_size;
-	m->size = 0;
-
-	/* Rehash the elements */
-	for (i = 0; i < old_size; i++)
+	int j = 0;
+	for (int i = 0; i < m->data_size; i++)
 	{
-		int status;
-
-		if (curr[i].in_use == 0)
+		if (m->data[i].key == NULL)
 			continue;
-
-		status = hashmap_put(m, curr[i].key, curr[i].data);
-		if (status != MAP_OK)
-			return status;
+		m->data[j] = m->data[i];
+		j++;
+		const hashmap_slot s = {(uint32_t)m->data[j - 1].hash, (uint32_t)j};
+		hashmap_insert_slot(m, s);
 	}
-
-	free(curr);
-
+	m->data_size = j;
 	return MAP_OK;
 }
 
 /*
- * Add a pointer to the hashmap with some key
+ * Add a pointer to the hashmap with some key, replacing any existing value
  */
 int hashmap_put(map_t m, const char *key, any_t value)
 {
-	int index;
+	const size_t len = strlen(key);
+	const uint64_t hash = hashmap_hash_str(key, len);
+	const int pos = hashmap_find(m, key, hash);
+	if (pos >= 0)
+	{
+		m->data[m->slots[pos].index - 1].data = value;
+		return MAP_OK;
+	}
 
-	/* Find a place to put our value */
-	index = hashmap_hash(m, key);
-	while (index == MAP_FULL)
+	const int table_size = (int)m->mask + 1;
+	if ((m->size + 1) * MAX_LOAD_DEN > table_size * MAX_LOAD_NUM)
 	{
-		if (hashmap_rehash(m) == MAP_OMEM)
-		{
+		if (hashmap_rehash(m, table_size * 2) != MAP_OK)
 			return MAP_OMEM;
+	}
+	if (m->data_size == m->data_cap)
+	{
+		if (m->size < m->data_size)
+		{
+			// Reclaim removed elements before growing
+			if (hashmap_rehash(m, (int)m->mask + 1) != MAP_OK)
+				return MAP_OMEM;
+		}
+		if (m->data_size == m->data_cap)
+		{
+			hashmap_element *data = (hashmap_element *)realloc(
+				m->data, 2 * m->data_cap * sizeof(hashmap_element));
+			if (!data)
+				return MAP_OMEM;
+			m->data = data;
+			m->data_cap *= 2;
 		}
-		index = hashmap_hash(m, key);
 	}
 
-	/* Set the data */
-	m->data[index].data = value;
-	m->data[index].key = malloc(strlen(key) + 1);
-	strcpy(m->data[index].key, key);
-	m->data[index].in_use = true;
+	char *keyCopy = malloc(len + 1);
+	if (!keyCopy)
+		return MAP_OMEM;
+	memcpy(keyCopy, key, len + 1);
+
+	hashmap_element *e = &m->data[m->data_size];
+	e->hash = hash;
+	e->key = keyCopy;
+	e->data = value;
+	m->data_size++;
 	m->size++;
+	const hashmap_slot s = {(uint32_t)hash, (uint32_t)m->data_size};
+	hashmap_insert_slot(m, s);
 
 	return MAP_OK;
 }
@@ -331,116 +324,85 @@ int hashmap_put(map_t m, const char *key, any_t value)
  */
 int hashmap_get(const map_t m, const char *key, any_t *arg)
 {
-	int curr;
-	int i;
-
-	/* Find data location */
-	curr = hashmap_hash_int(m, key);
-
-	/* Linear probing, if necessary */
-	for (i = 0; i < MAX_CHAIN_LENGTH; i++)
+	const int pos = hashmap_find(m, key, hashmap_hash_str(key, strlen(key)));
+	if (pos < 0)
 	{
-
-		int in_use = m->data[curr].in_use;
-		if (in_use == 1)
+		if (arg)
 		{
-			if (strcmp(m->data[curr].key, key) == 0)
-			{
-				if (arg)
-				{
-					*arg = (m->data[curr].data);
-				}
-				return MAP_OK;
-			}
+			*arg = NULL;
 		}
-
-		curr = (curr + 1) % m->table_size;
+		return MAP_MISSING;
 	}
-
 	if (arg)
 	{
-		*arg = NULL;
+		*arg = m->data[m->slots[pos].index - 1].data;
 	}
-
-	/* Not found */
-	return MAP_MISSING;
+	return MAP_OK;
 }
 
 /*
  * Iterate the function parameter over each element in the hashmap.  The
  * additional any_t argument is passed to the function as its first
  * argument and the hashmap element is the second.
+ * Elements are visited in insertion order.
  */
-static int iterate(
-	map_t m, PFany f, any_t item, int (*func)(hashmap_element, PFany, any_t));
-static int iterate_data(hashmap_element elem, PFany f, any_t item);
-int hashmap_iterate(map_t m, PFany f, any_t item)
+static int iterate(map_t m, PFany f, any_t item, const bool keys)
 {
-	return iterate(m, f, item, iterate_data);
+	/* On empty hashmap, return immediately */
+	if (hashmap_length(m) <= 0)
+		return MAP_MISSING;
+
+	for (int i = 0; i < m->data_size; i++)
+	{
+		const hashmap_element *e = &m->data[i];
+		if (e->key == NULL)
+			continue;
+		const int status = f(item, keys ? (any_t)e->key : e->data);
+		if (status != MAP_OK)
+		{
+			return status;
+		}
+	}
+
+	return MAP_OK;
 }
-static int iterate_data(hashmap_element elem, PFany f, any_t item)
+int hashmap_iterate(map_t m, PFany f, any_t item)
 {
-	return f(item, elem.data);
+	return iterate(m, f, item, false);
 }
-static int iterate_key(hashmap_element elem, PFany f, any_t item);
 int hashmap_iterate_keys(map_t m, PFany f, any_t item)
 {
-	return iterate(m, f, item, iterate_key);
-}
-static int iterate_key(hashmap_element elem, PFany f, any_t item)
-{
-	return f(item, elem.key);
-}
-static int iterate(
-    map_t m, PFany f, any_t item, int (*func)(hashmap_element, PFany, any_t))
-{
-    /* On empty hashmap, return immediately */
-    if (hashmap_length(m) <= 0)
-        return MAP_MISSING;
-
-    for (int i = 0; i < m->table_size; i++)
-        if (m->data[i].in_use)
-        {
-            const int status = func(m->data[i], f, item);
-            if (status != MAP_OK)
-            {
-                return status;
-            }
-        }
-
-    return MAP_OK;
+	return iterate(m, f, item, true);
 }
 
 static int key_comp(const void *v1, const void *v2);
 int hashmap_iterate_keys_sorted(map_t m, PFany f, any_t item)
 {
-    if (hashmap_length(m) <= 0) return MAP_MISSING;
-    map_t sorted_map = hashmap_copy(m, NULL);
-    qsort(sorted_map->data, sorted_map->table_size, sizeof sorted_map->data[0], key_comp);
-    for (int i = 0; i < sorted_map->table_size; i++)
-    {
-        const hashmap_element elem = sorted_map->data[i];
-        if (elem.in_use)
-        {
-            any_t data;
-            const int status = hashmap_get(m, elem.key, &data);
-            if (status != MAP_OK)
-            {
-                return status;
-            }
-            f(item, elem.key);
-        }
-    }
-    hashmap_destroy(sorted_map, NULL);
-    return MAP_OK;
+	if (hashmap_length(m) <= 0)
+		return MAP_MISSING;
+	char **keys = malloc(m->size * sizeof *keys);
+	if (!keys)
+		return MAP_OMEM;
+	int n = 0;
+	for (int i = 0; i < m->data_size; i++)
+	{
+		if (m->data[i].key != NULL)
+		{
+			keys[n++] = m->data[i].key;
+		}
+	}
+	qsort(keys, n, sizeof *keys, key_comp);
+	int status = MAP_OK;
+	for (int i = 0; i < n && status == MAP_OK; i++)
+	{
+		status = f(item, keys[i]);
+	}
+	free(keys);
+	return status;
 }
 static int key_comp(const void *v1, const void *v2)
 {
-    const hashmap_element *c1 = v1;
-    const hashmap_element *c2 = v2;
-    if (!c1->in_use) return 1;
-    if (!c2->in_use) return -1;
-    return strcmp(c1->key, c2->key);
+	return strcmp(*(char *const *)v1, *(char *const *)v2);
 }
 
 static int hashmap_return_first(any_t data, any_t item);
@@ -467,37 +429,31 @@ int hashmap_get_one_key(map_t m, any_t *arg)
  */
 int hashmap_remove(map_t m, char *key)
 {
-	int i;
-	int curr;
-
-	/* Find key */
-	curr = hashmap_hash_int(m, key);
-
-	/* Linear probing, if necessary */
-	for (i = 0; i < MAX_CHAIN_LENGTH; i++)
+	const int found = hashmap_find(m, key, hashmap_hash_str(key, strlen(key)));
+	if (found < 0)
+		return MAP_MISSING;
+	uint32_t pos = (uint32_t)found;
+
+	/* Blank out the element; it is compacted away on the next rehash */
+	hashmap_element *e = &m->data[m->slots[pos].index - 1];
+	free(e->key);
+	e->key = NULL;
+	e->data = NULL;
+	m->size--;
+
+	/* Backward shift deletion, so no tombstones in the probe table */
+	for (;;)
 	{
-
-		int in_use = m->data[curr].in_use;
-		if (in_use == 1)
-		{
-			if (strcmp(m->data[curr].key, key) == 0)
-			{
-				/* Blank out the fields */
-				m->data[curr].in_use = 0;
-				m->data[curr].data = NULL;
-				free(m->data[curr].key);
-				m->data[curr].key = NULL;
-
-				/* Reduce the size */
-				m->size--;
-				return MAP_OK;
-			}
-		}
-		curr = (curr + 1) % m->table_size;
+		const uint32_t next = (pos + 1) & m->mask;
+		const hashmap_slot s = m->slots[next];
+		if (s.index == 0 || slot_distance(m, next, s.hash) == 0)
+			break;
+		m->slots[pos] = s;
+		pos = next;
 	}
+	m->slots[pos].index = 0;
 
-	/* Data not found */
-	return MAP_MISSING;
+	return MAP_OK;
 }
 
 static int hashmap_destroy_item_callback(any_t a, any_t b);
@@ -508,12 +464,12 @@ void hashmap_clear(map_t m, void (*callback)(any_t))
 	// Deallocate keys
 	if (m != NULL)
 	{
-		for (int i = 0; i < m->table_size; i++)
-			if (m->data[i].in_use)
-			{
-				m->data[i].in_use = 0;
-				free(m->data[i].key);
-			}
+		for (int i = 0; i < m->data_size; i++)
+		{
+			free(m->data[i].key);
+		}
+		memset(m->slots, 0, ((size_t)m->mask + 1) * sizeof(hashmap_slot));
+		m->data_size = 0;
 		m->size = 0;
 	}
 }
@@ -522,14 +478,14 @@ void hashmap_clear(map_t m, void (*callback)(any_t))
 void hashmap_free(map_t m)
 {
 	// Deallocate keys
-	if (m != NULL && m->data != NULL)
+	if (m != NULL)
 	{
-		for (int i = 0; i < m->table_size; i++)
-			if (m->data[i].in_use)
-			{
-				free(m->data[i].key);
-			}
+		for (int i = 0; i < m->data_size; i++)
+		{
+			free(m->data[i].key);
+		}
 		free(m->data);
+		free(m->slots);
 	}
 	free(m);
 }
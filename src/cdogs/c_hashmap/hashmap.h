@@ -46,7 +46,7 @@ map_t hashmap_copy(const map_t in, any_t (*callback)(any_t));
 
 /*
  * Iteratively call f with argument (item, data) for
- * each element data in the hashmap. The function must
+ * each element data in the hashmap, in insertion order. The function must
  * return a map status code. If it returns anything other
  * than MAP_OK the traversal is terminated. f must
  * not reenter any hashmap functions, or deadlock may arise.
@@ -56,7 +56,8 @@ int hashmap_iterate_keys(map_t in, PFany f, any_t item);
 int hashmap_iterate_keys_sorted(map_t in, PFany f, any_t item);
 
 /*
- * Add an element to the hashmap. Return MAP_OK or MAP_OMEM.
+ * Add an element to the hashmap, replacing the value of an existing key.
+ * The key is copied. Return MAP_OK or MAP_OMEM.
  */
 int hashmap_put(map_t in, const char* key, any_t value);
 
@@ -0,0 +1,276 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "campaign_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "log.h"
+#include "sys_config.h"
+#include "utils.h"
+
+// Bump when the file layout or the scan results change
+#define CAMPAIGN_CACHE_VERSION 1
+static const char sMagic[4] = {'C', 'D', 'C', 'C'};
+
+typedef struct
+{
+	char *Path;
+	char *Title;
+	bool OK;
+	int NumMissions;
+	int64_t MTime;
+	int64_t Size;
+	// Whether this entry is still in use and should be saved
+	bool Used;
+} CampaignCacheEntry;
+
+static void EntryDestroy(any_t data)
+{
+	CampaignCacheEntry *e = data;
+	CFREE(e->Path);
+	CFREE(e->Title);
+	CFREE(e);
+}
+
+void CampaignCacheInit(CampaignCache *c)
+{
+	memset(c, 0, sizeof *c);
+	c->entries = hashmap_new();
+}
+void CampaignCacheTerminate(CampaignCache *c)
+{
+	hashmap_destroy(c->entries, EntryDestroy);
+	memset(c, 0, sizeof *c);
+}
+
+// Campaign archives are folders; their campaign.json holds the scanned data.
+// Spear of Destiny missions are suffixed with "?N"; use the game file.
+static bool GetFileKey(const char *path, int64_t *mtime, int64_t *size)
+{
+	char buf[CDOGS_PATH_MAX];
+	sprintf(buf, "%s/campaign.json", path);
+	char filePath[CDOGS_PATH_MAX];
+	strcpy(filePath, path);
+	const size_t len = strlen(filePath);
+	if (len >= 2 && filePath[len - 2] == '?')
+	{
+		filePath[len - 2] = '\0';
+	}
+	struct stat st;
+	if (stat(buf, &st) != 0 && stat(filePath, &st) != 0)
+	{
+		return false;
+	}
+	*mtime = (int64_t)st.st_mtime;
+	*size = (int64_t)st.st_size;
+	return true;
+}
+
+static bool ReadStr(FILE *f, char **s)
+{
+	uint16_t len;
+	if (fread(&len, sizeof len, 1, f) != 1)
+	{
+		return false;
+	}
+	CMALLOC(*s, len + 1);
+	if (len > 0 && fread(*s, len, 1, f) != 1)
+	{
+		CFREE(*s);
+		*s = NULL;
+		return false;
+	}
+	(*s)[len] = '\0';
+	return true;
+}
+static bool ReadEntry(FILE *f, CampaignCacheEntry *e)
+{
+	int32_t numMissions;
+	uint8_t ok;
+	return ReadStr(f, &e->Path) && ReadStr(f, &e->Title) &&
+		   fread(&ok, sizeof ok, 1, f) == 1 &&
+		   fread(&numMissions, sizeof numMissions, 1, f) == 1 &&
+		   fread(&e->MTime, sizeof e->MTime, 1, f) == 1 &&
+		   fread(&e->Size, sizeof e->Size, 1, f) == 1 &&
+		   (e->OK = ok != 0, e->NumMissions = numMissions, true);
+}
+void CampaignCacheLoad(CampaignCache *c, const char *filename)
+{
+	FILE *f = fopen(filename, "rb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_DEBUG, "No campaign cache %s", filename);
+		return;
+	}
+	char magic[sizeof sMagic];
+	uint32_t version;
+	uint32_t count;
+	if (fread(magic, sizeof magic, 1, f) != 1 ||
+		memcmp(magic, sMagic, sizeof magic) != 0 ||
+		fread(&version, sizeof version, 1, f) != 1 ||
+		version != CAMPAIGN_CACHE_VERSION ||
+		fread(&count, sizeof count, 1, f) != 1)
+	{
+		LOG(LM_MAIN, LL_INFO, "Ignoring stale campaign cache %s", filename);
+		goto bail;
+	}
+	for (uint32_t i = 0; i < count; i++)
+	{
+		CampaignCacheEntry *e;
+		CCALLOC(e, sizeof *e);
+		if (!ReadEntry(f, e))
+		{
+			LOG(LM_MAIN, LL_ERROR, "Corrupt campaign cache %s", filename);
+			EntryDestroy(e);
+			hashmap_clear(c->entries, EntryDestroy);
+			goto bail;
+		}
+		if (hashmap_put(c->entries, e->Path, e) != MAP_OK)
+		{
+			EntryDestroy(e);
+		}
+	}
+	LOG(LM_MAIN, LL_DEBUG, "Loaded %u cached campaigns", count);
+
+bail:
+	fclose(f);
+}
+
+static void WriteStr(FILE *f, const char *s)
+{
+	const uint16_t len = (uint16_t)MIN(strlen(s), UINT16_MAX);
+	fwrite(&len, sizeof len, 1, f);
+	fwrite(s, len, 1, f);
+}
+static int CountUsed(any_t data, any_t item)
+{
+	const CampaignCacheEntry *e = item;
+	if (e->Used)
+	{
+		(*(uint32_t *)data)++;
+	}
+	return MAP_OK;
+}
+static int WriteEntry(any_t data, any_t item)
+{
+	FILE *f = data;
+	const CampaignCacheEntry *e = item;
+	if (!e->Used)
+	{
+		return MAP_OK;
+	}
+	WriteStr(f, e->Path);
+	WriteStr(f, e->Title);
+	const uint8_t ok = e->OK;
+	fwrite(&ok, sizeof ok, 1, f);
+	const int32_t numMissions = e->NumMissions;
+	fwrite(&numMissions, sizeof numMissions, 1, f);
+	fwrite(&e->MTime, sizeof e->MTime, 1, f);
+	fwrite(&e->Size, sizeof e->Size, 1, f);
+	return MAP_OK;
+}
+void CampaignCacheSave(CampaignCache *c, const char *filename)
+{
+	uint32_t count = 0;
+	hashmap_iterate(c->entries, CountUsed, &count);
+	// Nothing changed; don't rewrite the file
+	if (!c->dirty && count == (uint32_t)hashmap_length(c->entries))
+	{
+		return;
+	}
+	FILE *f = fopen(filename, "wb");
+	if (f == NULL)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Cannot save campaign cache %s", filename);
+		return;
+	}
+	fwrite(sMagic, sizeof sMagic, 1, f);
+	const uint32_t version = CAMPAIGN_CACHE_VERSION;
+	fwrite(&version, sizeof version, 1, f);
+	fwrite(&count, sizeof count, 1, f);
+	hashmap_iterate(c->entries, WriteEntry, f);
+	if (fclose(f) != 0)
+	{
+		LOG(LM_MAIN, LL_ERROR, "Error saving campaign cache %s", filename);
+	}
+	c->dirty = false;
+}
+
+bool CampaignCacheGet(
+	CampaignCache *c, const char *path, bool *ok, char **title,
+	int *numMissions)
+{
+	CampaignCacheEntry *e;
+	if (hashmap_get(c->entries, path, (any_t *)&e) != MAP_OK)
+	{
+		return false;
+	}
+	int64_t mtime, size;
+	if (!GetFileKey(path, &mtime, &size) || mtime != e->MTime ||
+		size != e->Size)
+	{
+		return false;
+	}
+	e->Used = true;
+	*ok = e->OK;
+	if (e->OK)
+	{
+		CSTRDUP(*title, e->Title);
+		*numMissions = e->NumMissions;
+	}
+	return true;
+}
+void CampaignCachePut(
+	CampaignCache *c, const char *path, const bool ok, const char *title,
+	const int numMissions)
+{
+	int64_t mtime, size;
+	if (!GetFileKey(path, &mtime, &size))
+	{
+		return;
+	}
+	CampaignCacheEntry *e;
+	if (hashmap_get(c->entries, path, (any_t *)&e) != MAP_OK)
+	{
+		CCALLOC(e, sizeof *e);
+		CSTRDUP(e->Path, path);
+		if (hashmap_put(c->entries, e->Path, e) != MAP_OK)
+		{
+			EntryDestroy(e);
+			return;
+		}
+	}
+	CFREE(e->Title);
+	CSTRDUP(e->Title, ok && title != NULL ? title : "");
+	e->OK = ok;
+	e->NumMissions = numMissions;
+	e->MTime = mtime;
+	e->Size = size;
+	e->Used = true;
+	c->dirty = true;
+}
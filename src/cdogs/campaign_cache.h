@@ -0,0 +1,59 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "c_hashmap/hashmap.h"
+
+#define CAMPAIGN_CACHE_FILE "campaigns.cache"
+
+// Scanned campaign titles and mission counts, keyed by path and checked
+// against the file's modification time and size, so that the campaign
+// list doesn't need to parse every campaign on startup
+typedef struct
+{
+	map_t entries; // of CampaignCacheEntry *
+	bool dirty;
+} CampaignCache;
+
+void CampaignCacheInit(CampaignCache *c);
+void CampaignCacheTerminate(CampaignCache *c);
+// Load a cache file; missing, stale-versioned or corrupt files are ignored
+void CampaignCacheLoad(CampaignCache *c, const char *filename);
+// Save the entries that were looked up or added since loading
+void CampaignCacheSave(CampaignCache *c, const char *filename);
+
+// Returns whether there is an up-to-date entry for the campaign path.
+// If the campaign was found to be invalid, *ok is false.
+bool CampaignCacheGet(
+	CampaignCache *c, const char *path, bool *ok, char **title,
+	int *numMissions);
+// Add the scan result of a campaign; invalid campaigns are also cached
+void CampaignCachePut(
+	CampaignCache *c, const char *path, const bool ok, const char *title,
+	const int numMissions);
@@ -84,10 +84,27 @@ void CampaignEntryCopy(CampaignEntry *dst, const CampaignEntry *src)
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode)
 {
-	char *buf;
-	int numMissions;
-	if (!IsCampaignOK(path, &buf, &numMissions))
+	return CampaignEntryTryLoadCached(entry, path, mode, NULL);
+}
+bool CampaignEntryTryLoadCached(
+	CampaignEntry *entry, const char *path, GameMode mode,
+	CampaignCache *cache)
+{
+	char *buf = NULL;
+	int numMissions = 0;
+	bool ok;
+	if (cache == NULL ||
+		!CampaignCacheGet(cache, path, &ok, &buf, &numMissions))
+	{
+		ok = IsCampaignOK(path, &buf, &numMissions);
+		if (cache != NULL)
+		{
+			CampaignCachePut(cache, path, ok, buf, numMissions);
+		}
+	}
+	if (!ok)
 	{
+		CFREE(buf);
 		return false;
 	}
 	// cap length of title
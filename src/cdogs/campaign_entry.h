@@ -28,6 +28,7 @@
 */
 #pragma once
 
+#include "campaign_cache.h"
 #include "game_mode.h"
 
 typedef struct
@@ -43,6 +44,10 @@ void CampaignEntryInit(CampaignEntry *entry, const char *title, GameMode mode);
 void CampaignEntryCopy(CampaignEntry *dst, const CampaignEntry *src);
 bool CampaignEntryTryLoad(
 	CampaignEntry *entry, const char *path, GameMode mode);
+// As above, but look up and record the scan result in a campaign cache
+bool CampaignEntryTryLoadCached(
+	CampaignEntry *entry, const char *path, GameMode mode,
+	CampaignCache *cache);
 void CampaignEntryTerminate(CampaignEntry *entry);
 
 bool IsCampaignOK(const char *path, char **buf, int *numMissions);
@@ -183,47 +183,157 @@ bool CampaignListIsEmpty(const CampaignList *c)
 
 static void CampaignListInit(CampaignList *list);
 static void CampaignListTerminate(CampaignList *list);
-static void LoadCampaignsFromFolder(
-	CampaignList *list, const char *name, const char *path,
-	const GameMode mode);
+
+// A campaign found by the background scan, waiting to be added to its list
+typedef struct
+{
+	bool IsDogfight;
+	// Subfolders of the list, each terminated with '/'
+	char *Folder;
+	CampaignEntry Entry;
+} CampaignScanResult;
+
+static int ScanCampaigns(void *data);
 static void LoadQuickPlayEntry(CampaignEntry *entry);
 
 void LoadAllCampaigns(CustomCampaigns *campaigns)
 {
 	MapWolfInit();
 
-	char buf[CDOGS_PATH_MAX];
-
 	CampaignListInit(&campaigns->campaignList);
+	CSTRDUP(campaigns->campaignList.Name, "");
 	CampaignListInit(&campaigns->dogfightList);
-
-	LOG(LM_MAIN, LL_INFO, "Load campaigns from system...");
-	MapWolfLoadCampaignsFromSystem(&campaigns->campaignList);
-
-	GetDataFilePath(buf, CDOGS_CAMPAIGN_DIR);
-	LOG(LM_MAIN, LL_INFO, "Load campaigns from dir %s...", buf);
-	LoadCampaignsFromFolder(
-		&campaigns->campaignList, "", buf, GAME_MODE_NORMAL);
-
-	GetDataFilePath(buf, CDOGS_DOGFIGHT_DIR);
-	LOG(LM_MAIN, LL_INFO, "Load dogfights from dir %s...", buf);
-	LoadCampaignsFromFolder(
-		&campaigns->dogfightList, "", buf, GAME_MODE_DOGFIGHT);
+	CSTRDUP(campaigns->dogfightList.Name, "");
 
 	LOG(LM_MAIN, LL_INFO, "Load quick play...");
 	LoadQuickPlayEntry(&campaigns->quickPlayEntry);
+
+	// Scanning opens every campaign; do it in the background and let the
+	// menus pick up entries as they are found
+	CArrayInit(&campaigns->scanned, sizeof(CampaignScanResult));
+	campaigns->scanDone = false;
+	campaigns->scanCancel = false;
+	// GetConfigFilePath uses a static buffer, so resolve it here
+	strcpy(campaigns->scanCachePath, GetConfigFilePath(CAMPAIGN_CACHE_FILE));
+	campaigns->scanLock = SDL_CreateMutex();
+	campaigns->scanThread =
+		SDL_CreateThread(ScanCampaigns, "ScanCampaigns", campaigns);
+	if (campaigns->scanThread == NULL)
+	{
+		LOG(LM_MAIN, LL_WARN, "Cannot create scan thread (%s), scanning now",
+			SDL_GetError());
+		ScanCampaigns(campaigns);
+		CampaignsUpdateScan(campaigns);
+	}
 }
 
+static void CampaignScanResultsTerminate(CArray *results)
+{
+	CA_FOREACH(CampaignScanResult, r, *results)
+	CFREE(r->Folder);
+	CampaignEntryTerminate(&r->Entry);
+	CA_FOREACH_END()
+	CArrayTerminate(results);
+}
 void UnloadAllCampaigns(CustomCampaigns *campaigns)
 {
+	if (campaigns && campaigns->scanThread)
+	{
+		// Stop the scan before freeing what it uses
+		SDL_LockMutex(campaigns->scanLock);
+		campaigns->scanCancel = true;
+		SDL_UnlockMutex(campaigns->scanLock);
+		SDL_WaitThread(campaigns->scanThread, NULL);
+		campaigns->scanThread = NULL;
+	}
 	MapWolfTerminate();
 	if (campaigns)
 	{
+		CampaignScanResultsTerminate(&campaigns->scanned);
+		if (campaigns->scanLock)
+		{
+			SDL_DestroyMutex(campaigns->scanLock);
+			campaigns->scanLock = NULL;
+		}
 		CampaignListTerminate(&campaigns->campaignList);
 		CampaignListTerminate(&campaigns->dogfightList);
 	}
 }
 
+bool CampaignsUpdateScan(CustomCampaigns *campaigns)
+{
+	if (campaigns->scanLock == NULL)
+	{
+		return false;
+	}
+	SDL_LockMutex(campaigns->scanLock);
+	CArray results = campaigns->scanned;
+	CArrayInit(&campaigns->scanned, sizeof(CampaignScanResult));
+	const bool done = campaigns->scanDone;
+	SDL_UnlockMutex(campaigns->scanLock);
+
+	const bool changed = results.size > 0 || done;
+	CA_FOREACH(CampaignScanResult, r, results)
+	CampaignList *list = CampaignListGetFolder(
+		r->IsDogfight ? &campaigns->dogfightList : &campaigns->campaignList,
+		r->Folder, true);
+	CArrayPushBack(&list->list, &r->Entry);
+	CFREE(r->Folder);
+	CA_FOREACH_END()
+	CArrayTerminate(&results);
+
+	if (done)
+	{
+		if (campaigns->scanThread)
+		{
+			SDL_WaitThread(campaigns->scanThread, NULL);
+			campaigns->scanThread = NULL;
+		}
+		SDL_DestroyMutex(campaigns->scanLock);
+		campaigns->scanLock = NULL;
+		LOG(LM_MAIN, LL_INFO, "Campaign scan complete");
+	}
+	return changed;
+}
+bool CampaignsIsScanning(const CustomCampaigns *campaigns)
+{
+	return campaigns->scanLock != NULL;
+}
+
+CampaignList *CampaignListGetFolder(
+	CampaignList *list, const char *folder, const bool create)
+{
+	for (const char *p = folder; *p != '\0';)
+	{
+		const char *end = strchr(p, '/');
+		const size_t len = end - p;
+		CampaignList *sub = NULL;
+		CA_FOREACH(CampaignList, s, list->subFolders)
+		if (strlen(s->Name) == len && strncmp(s->Name, p, len) == 0)
+		{
+			sub = s;
+			break;
+		}
+		CA_FOREACH_END()
+		if (sub == NULL)
+		{
+			if (!create)
+			{
+				return NULL;
+			}
+			CampaignList newList;
+			CampaignListInit(&newList);
+			CMALLOC(newList.Name, len + 1);
+			strncpy(newList.Name, p, len);
+			newList.Name[len] = '\0';
+			sub = CArrayPushBack(&list->subFolders, &newList);
+		}
+		list = sub;
+		p = end + 1;
+	}
+	return list;
+}
+
 static void CampaignListInit(CampaignList *list)
 {
 	list->Name = NULL;
@@ -251,21 +361,86 @@ static void LoadQuickPlayEntry(CampaignEntry *entry)
 	entry->Mode = GAME_MODE_QUICK_PLAY;
 }
 
-static void LoadCampaignsFromFolder(
-	CampaignList *list, const char *name, const char *path,
-	const GameMode mode)
+static bool IsScanCancelled(CustomCampaigns *campaigns)
+{
+	SDL_LockMutex(campaigns->scanLock);
+	const bool cancel = campaigns->scanCancel;
+	SDL_UnlockMutex(campaigns->scanLock);
+	return cancel;
+}
+static void AddScanResult(
+	CustomCampaigns *campaigns, const bool isDogfight, const char *folder,
+	const CampaignEntry *entry)
+{
+	CampaignScanResult r;
+	r.IsDogfight = isDogfight;
+	CSTRDUP(r.Folder, folder);
+	r.Entry = *entry;
+	SDL_LockMutex(campaigns->scanLock);
+	CArrayPushBack(&campaigns->scanned, &r);
+	SDL_UnlockMutex(campaigns->scanLock);
+}
+static void ScanCampaignsFromFolder(
+	CustomCampaigns *campaigns, const bool isDogfight, const char *folder,
+	const char *path, const GameMode mode, CampaignCache *cache);
+static int ScanCampaigns(void *data)
+{
+	CustomCampaigns *campaigns = data;
+	char buf[CDOGS_PATH_MAX];
+
+	// System installs go first, so the default Wolfenstein maps are set
+	// before any campaigns that depend on them are listed
+	LOG(LM_MAIN, LL_INFO, "Load campaigns from system...");
+	CampaignList systemList;
+	CampaignListInit(&systemList);
+	MapWolfLoadCampaignsFromSystem(&systemList);
+	CA_FOREACH(CampaignEntry, e, systemList.list)
+	AddScanResult(campaigns, false, "", e);
+	CA_FOREACH_END()
+	// Entries are now owned by the scan results
+	CArrayClear(&systemList.list);
+	CampaignListTerminate(&systemList);
+
+	CampaignCache cache;
+	CampaignCacheInit(&cache);
+	CampaignCacheLoad(&cache, campaigns->scanCachePath);
+
+	GetDataFilePath(buf, CDOGS_CAMPAIGN_DIR);
+	LOG(LM_MAIN, LL_INFO, "Load campaigns from dir %s...", buf);
+	ScanCampaignsFromFolder(
+		campaigns, false, "", buf, GAME_MODE_NORMAL, &cache);
+
+	GetDataFilePath(buf, CDOGS_DOGFIGHT_DIR);
+	LOG(LM_MAIN, LL_INFO, "Load dogfights from dir %s...", buf);
+	ScanCampaignsFromFolder(
+		campaigns, true, "", buf, GAME_MODE_DOGFIGHT, &cache);
+
+	// Don't save a partial scan; it would drop the entries not visited
+	if (!IsScanCancelled(campaigns))
+	{
+		CampaignCacheSave(&cache, campaigns->scanCachePath);
+	}
+	CampaignCacheTerminate(&cache);
+
+	SDL_LockMutex(campaigns->scanLock);
+	campaigns->scanDone = true;
+	SDL_UnlockMutex(campaigns->scanLock);
+	return 0;
+}
+static void ScanCampaignsFromFolder(
+	CustomCampaigns *campaigns, const bool isDogfight, const char *folder,
+	const char *path, const GameMode mode, CampaignCache *cache)
 {
 	tinydir_dir dir;
 	int i;
 
-	CSTRDUP(list->Name, name);
 	if (tinydir_open_sorted(&dir, path) == -1)
 	{
 		printf("Cannot load campaigns from path %s\n", path);
 		return;
 	}
 
-	for (i = 0; i < (int)dir.n_files; i++)
+	for (i = 0; i < (int)dir.n_files && !IsScanCancelled(campaigns); i++)
 	{
 		tinydir_file file;
 		tinydir_readfile_n(&dir, &file, i);
@@ -279,22 +454,16 @@ static void LoadCampaignsFromFolder(
 							   strcmp(file.extension, "CDOGSCPN") == 0;
 		if (file.is_dir && !isArchive)
 		{
-			CampaignList subFolder;
-			CampaignListInit(&subFolder);
-			LoadCampaignsFromFolder(&subFolder, file.name, file.path, mode);
-			if (CampaignListIsEmpty(&subFolder))
-			{
-				CampaignListTerminate(&subFolder);
-			}
-			else
-			{
-				CArrayPushBack(&list->subFolders, &subFolder);
-			}
+			// Subfolders are only listed once they have an entry
+			char subFolder[CDOGS_PATH_MAX];
+			sprintf(subFolder, "%s%s/", folder, file.name);
+			ScanCampaignsFromFolder(
+				campaigns, isDogfight, subFolder, file.path, mode, cache);
 		}
 		CampaignEntry entry;
-		if (CampaignEntryTryLoad(&entry, file.path, mode))
+		if (CampaignEntryTryLoadCached(&entry, file.path, mode, cache))
 		{
-			CArrayPushBack(&list->list, &entry);
+			AddScanResult(campaigns, isDogfight, folder, &entry);
 		}
 	}
 
@@ -28,6 +28,9 @@
 */
 #pragma once
 
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
+
 #include "c_array.h"
 #include "campaign_entry.h"
 #include "character.h"
@@ -46,6 +49,14 @@ typedef struct
 	CampaignList campaignList;
 	CampaignList dogfightList;
 	CampaignEntry quickPlayEntry;
+	// Campaigns are scanned on a background thread; results are queued
+	// under scanLock and moved into the lists by CampaignsUpdateScan
+	SDL_Thread *scanThread;
+	SDL_mutex *scanLock;
+	CArray scanned; // of CampaignScanResult
+	bool scanDone;
+	bool scanCancel;
+	char scanCachePath[CDOGS_PATH_MAX];
 } CustomCampaigns;
 
 typedef struct
@@ -99,9 +110,17 @@ int CampaignGetExcessHP(const Campaign *c);
 int CampaignGetHP(const Campaign *c);
 
 bool CampaignListIsEmpty(const CampaignList *c);
+// Get a subfolder list by its path, e.g. "a/b/"
+CampaignList *CampaignListGetFolder(
+	CampaignList *list, const char *folder, const bool create);
 
+// Starts scanning campaigns in the background
 void LoadAllCampaigns(CustomCampaigns *campaigns);
 void UnloadAllCampaigns(CustomCampaigns *campaigns);
+// Add campaigns found since the last call to the lists.
+// Must be called from the main thread; returns whether the lists changed.
+bool CampaignsUpdateScan(CustomCampaigns *campaigns);
+bool CampaignsIsScanning(const CustomCampaigns *campaigns);
 
 Mission *CampaignGetCurrentMission(Campaign *campaign);
 void CampaignSeedRandom(const Campaign *campaign);
@@ -48,6 +48,8 @@
 */
 #include "collision.h"
 
+#include <math.h>
+
 #include "actors.h"
 #include "algorithms.h"
 #include "campaigns.h"
@@ -327,6 +329,179 @@ void OverlapThings(
 	}
 	CA_FOREACH_END()
 }
+bool OverlapThingsMayHit(
+	const Thing *item, const struct vec2 pos, const struct vec2 vel,
+	const struct vec2i size, const CollisionParams params)
+{
+	// Scan a rectangle of tiles containing every tile that OverlapThings
+	// would add to its tile cache: the motion path and the area around the
+	// object, each grown by one tile for adjacencies
+	const int dtx = (size.x + TILE_WIDTH - 1) / 2 / TILE_WIDTH;
+	const int dty = (size.y + TILE_HEIGHT - 1) / 2 / TILE_HEIGHT;
+	const struct vec2i tv0 = Vec2iToTile(svec2i_assign_vec2(pos));
+	const struct vec2i tv1 =
+		Vec2iToTile(svec2i_assign_vec2(svec2_add(pos, vel)));
+	const struct vec2i tvMin = svec2i(
+		MAX(MIN(tv0.x, tv1.x) - dtx - 1, 0),
+		MAX(MIN(tv0.y, tv1.y) - dty - 1, 0));
+	const struct vec2i tvMax = svec2i(
+		MIN(MAX(tv0.x, tv1.x) + 2 * dtx + 1, gMap.Size.x - 1),
+		MIN(MAX(tv0.y, tv1.y) + 2 * dty + 1, gMap.Size.y - 1));
+	struct vec2i tv;
+	for (tv.y = tvMin.y; tv.y <= tvMax.y; tv.y++)
+	{
+		for (tv.x = tvMin.x; tv.x <= tvMax.x; tv.x++)
+		{
+			const CArray *tileThings = &MapGetTile(&gMap, tv)->things;
+			CA_FOREACH(const ThingId, tid, *tileThings)
+			const Thing *ti = ThingIdGetThing(tid);
+			if (ti != item &&
+				(params.ThingMask == 0 || (ti->flags & params.ThingMask)))
+			{
+				return true;
+			}
+			CA_FOREACH_END()
+		}
+	}
+	return false;
+}
+typedef struct
+{
+	struct vec2 pos;
+	struct vec2 vel;
+	CheckWallFunc checkWallFunc;
+	bool hit;
+	float dist2;
+	struct vec2i tilePos;
+	struct vec2 col;
+	struct vec2 normal;
+} RaycastWallsData;
+static void RaycastWallTile(RaycastWallsData *data, const struct vec2i tv)
+{
+	if (!MapIsTileIn(&gMap, tv) || !data->checkWallFunc(tv))
+	{
+		return;
+	}
+	struct vec2 colA, colB, normal;
+	if (!MinkowskiHexCollide(
+			data->pos, data->vel, svec2i_zero(), Vec2CenterOfTile(tv),
+			svec2_zero(), TILE_SIZE, &colA, &colB, &normal))
+	{
+		return;
+	}
+	// Break ties in y/x order, the same order as the tile cache
+	const float d2 = svec2_distance_squared(colA, data->pos);
+	if (!data->hit || d2 < data->dist2 ||
+		(d2 == data->dist2 &&
+		 (tv.y < data->tilePos.y ||
+		  (tv.y == data->tilePos.y && tv.x < data->tilePos.x))))
+	{
+		data->hit = true;
+		data->dist2 = d2;
+		data->tilePos = tv;
+		data->col = colA;
+		data->normal = normal;
+	}
+}
+// Fraction along the motion at which it crosses the next tile edge
+static float RaycastNextEdge(
+	const int tile, const int step, const int tileSize, const float pos,
+	const float vel)
+{
+	if (step == 0)
+	{
+		return INFINITY;
+	}
+	return ((tile + (step > 0 ? 1 : 0)) * tileSize - pos) / vel;
+}
+// Tolerance for rounding differences between the traversal and the
+// collision test, as a fraction of the motion
+#define RAYCAST_EPSILON 1e-4f
+bool RaycastWalls(
+	const struct vec2 pos, const struct vec2 vel, CheckWallFunc checkWallFunc,
+	struct vec2i *tilePos, struct vec2 *col, struct vec2 *normal)
+{
+	RaycastWallsData data;
+	data.pos = pos;
+	data.vel = vel;
+	data.checkWallFunc = checkWallFunc;
+	data.hit = false;
+
+	// Grid traversal (Amanatides-Woo), where t is the fraction along vel
+	struct vec2i tv = svec2i(
+		(int)floorf(pos.x / TILE_WIDTH), (int)floorf(pos.y / TILE_HEIGHT));
+	const struct vec2i step =
+		svec2i(vel.x > 0 ? 1 : (vel.x < 0 ? -1 : 0),
+			   vel.y > 0 ? 1 : (vel.y < 0 ? -1 : 0));
+
+	// Tile edges count as part of the wall, so starting on an edge, or moving
+	// along one, also touches the tiles on the other side
+	const bool onEdgeX = pos.x == tv.x * TILE_WIDTH;
+	const bool onEdgeY = pos.y == tv.y * TILE_HEIGHT;
+	RaycastWallTile(&data, tv);
+	if (onEdgeX)
+	{
+		RaycastWallTile(&data, svec2i(tv.x - 1, tv.y));
+	}
+	if (onEdgeY)
+	{
+		RaycastWallTile(&data, svec2i(tv.x, tv.y - 1));
+	}
+	if (onEdgeX && onEdgeY)
+	{
+		RaycastWallTile(&data, svec2i(tv.x - 1, tv.y - 1));
+	}
+
+	// Tiles are visited in order along the path; keep going just past the
+	// first hit in case a tile edge is hit at the same point
+	const float len2 = svec2_length_squared(vel);
+	for (;;)
+	{
+		const float tx =
+			RaycastNextEdge(tv.x, step.x, TILE_WIDTH, pos.x, vel.x);
+		const float ty =
+			RaycastNextEdge(tv.y, step.y, TILE_HEIGHT, pos.y, vel.y);
+		const float t = MIN(tx, ty);
+		if (t > 1 ||
+			(data.hit && t - sqrtf(data.dist2 / len2) > RAYCAST_EPSILON))
+		{
+			break;
+		}
+		const struct vec2i prev = tv;
+		if (fabsf(tx - ty) <= RAYCAST_EPSILON)
+		{
+			// Passing through a corner touches all the tiles around it
+			tv = svec2i_add(tv, step);
+			RaycastWallTile(&data, svec2i(prev.x, tv.y));
+			RaycastWallTile(&data, svec2i(tv.x, prev.y));
+		}
+		else if (tx < ty)
+		{
+			tv.x += step.x;
+		}
+		else
+		{
+			tv.y += step.y;
+		}
+		RaycastWallTile(&data, tv);
+		if (step.y == 0 && onEdgeY)
+		{
+			RaycastWallTile(&data, svec2i(tv.x, tv.y - 1));
+		}
+		if (step.x == 0 && onEdgeX)
+		{
+			RaycastWallTile(&data, svec2i(tv.x - 1, tv.y));
+		}
+	}
+
+	if (data.hit)
+	{
+		*tilePos = data.tilePos;
+		*col = data.col;
+		*normal = data.normal;
+	}
+	return data.hit;
+}
 static void AddPosToTileCache(void *data, struct vec2i pos)
 {
 	CArray *tileCache = data;
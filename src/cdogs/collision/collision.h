@@ -106,6 +106,17 @@ void OverlapThings(
 	const struct vec2i size, const CollisionParams params,
 	CollideItemFunc func, void *data, CheckWallFunc checkWallFunc,
 	CollideWallFunc wallFunc, void *wallData);
+// Cheap conservative test for whether OverlapThings could report any
+// things; false means the motion is guaranteed not to hit any
+bool OverlapThingsMayHit(
+	const Thing *item, const struct vec2 pos, const struct vec2 vel,
+	const struct vec2i size, const CollisionParams params);
+// Find the first wall that a zero-size object hits when moving from pos by
+// vel, walking only the tiles along the motion path.
+// Gives the same collision position and normal as OverlapThings.
+bool RaycastWalls(
+	const struct vec2 pos, const struct vec2 vel, CheckWallFunc checkWallFunc,
+	struct vec2i *tilePos, struct vec2 *col, struct vec2 *normal);
 // Get the first Thing that overlaps
 Thing *OverlapGetFirstItem(
 	const Thing *item, const struct vec2 pos, const struct vec2i size,
@@ -288,6 +288,7 @@ static Config ConfigNew(const char *name, const ConfigType type)
 
 void ConfigDestroy(Config *c)
 {
+	ConfigHandlesInvalidate();
 	CFREE(c->Name);
 	if (c->Type == CONFIG_TYPE_GROUP)
 	{
@@ -347,6 +348,39 @@ bail:
 	return c;
 }
 
+static int sConfigGeneration = 0;
+void ConfigHandlesInvalidate(void)
+{
+	sConfigGeneration++;
+}
+Config *ConfigHandleGet(ConfigHandle *h)
+{
+	if (h->generation != sConfigGeneration)
+	{
+		h->c = ConfigGet(&gConfig, h->Name);
+		h->generation = sConfigGeneration;
+	}
+	return h->c;
+}
+int ConfigHandleInt(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_INT, "wrong config type");
+	return c->u.Int.Value;
+}
+bool ConfigHandleBool(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_BOOL, "wrong config type");
+	return c->u.Bool.Value;
+}
+int ConfigHandleEnum(ConfigHandle *h)
+{
+	const Config *c = ConfigHandleGet(h);
+	CASSERT(c->Type == CONFIG_TYPE_ENUM, "wrong config type");
+	return c->u.Enum.Value;
+}
+
 bool ConfigChanged(const Config *c)
 {
 	switch (c->Type)
@@ -560,6 +594,7 @@ bool ConfigTrySetFromString(Config *c, const char *name, const char *value)
 
 Config ConfigDefault(void)
 {
+	ConfigHandlesInvalidate();
 	Config root = ConfigNewGroup(NULL);
 	
 	Config game = ConfigNewGroup("Game");
@@ -584,6 +619,9 @@ Config ConfigDefault(void)
 	ConfigGroupAdd(&game, ConfigNewBool("Fog", true));
 	ConfigGroupAdd(&game,
 		ConfigNewInt("SightRange", 15, 8, 40, 1, NULL, NULL));
+	// Sleeping AI farther than this many tiles from all players update less
+	ConfigGroupAdd(&game,
+		ConfigNewInt("AIUpdateRadius", 40, 10, 200, 5, NULL, NULL));
 	ConfigGroupAdd(&game, ConfigNewEnum(
 		"FireMoveStyle", FIREMOVE_STOP, FIREMOVE_STOP, FIREMOVE_STRAFE,
 		StrFireMoveStyle, FireMoveStyleStr));
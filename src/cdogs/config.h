@@ -230,5 +230,23 @@ void ConfigSetFloat(Config *c, const char *name, const double value);
 // Try to set config value from a string; return success
 bool ConfigTrySetFromString(Config *c, const char *name, const char *value);
 
+// Config entry in gConfig, looked up by name once and then cached.
+// Use in hot paths instead of ConfigGet*, e.g.
+// static ConfigHandle fog = CONFIG_HANDLE("Game.Fog");
+// if (ConfigHandleBool(&fog)) ...
+typedef struct
+{
+	const char *Name;
+	Config *c;
+	int generation;
+} ConfigHandle;
+#define CONFIG_HANDLE(_name) {_name, NULL, -1}
+// Invalidate all handles; call when gConfig is rebuilt or applied
+void ConfigHandlesInvalidate(void);
+Config *ConfigHandleGet(ConfigHandle *h);
+int ConfigHandleInt(ConfigHandle *h);
+bool ConfigHandleBool(ConfigHandle *h);
+int ConfigHandleEnum(ConfigHandle *h);
+
 bool ConfigApply(Config *config, bool *resetBg);
 int ConfigGetVersion(FILE *f);
@@ -50,5 +50,6 @@ bool ConfigApply(Config *config, bool *resetBg)
 		GraphicsInitialize(&gGraphicsDevice);
 	}
 	ConfigSetChanged(config);
+	ConfigHandlesInvalidate();
 	return gGraphicsDevice.IsInitialized;
 }
@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <SDL_mutex.h>
+
 #include "audio_bs6.h"
 #include "audio_n3d.h"
 #include "audio_sod.h"
@@ -12,12 +14,16 @@
 
 #define PATH_MAX 4096
 static int volume = 20;
+// Sounds are synthesised on the main thread and music is streamed on the
+// audio thread, so they use separate chips; the emulator has shared
+// state so all access goes through the lock
 static const int oplChip = 0;
+static const int oplMusicChip = 1;
+#define OPL_NUM_CHIPS 2
+static SDL_mutex *oplLock = NULL;
 #define OPL_CHANNELS 9
-#define MUSIC_RATE 700
 #define SOUND_RATE 140 // Also affects PC Speaker sounds
 #define SOUND_TICKS (MUSIC_RATE / SOUND_RATE)
-#define SAMPLES_PER_MUSIC_TICK (MUSIC_SAMPLE_RATE / MUSIC_RATE)
 
 #pragma pack(push, 1)
 typedef struct
@@ -45,7 +51,7 @@ static const AlInstrument ChannelRelease = {
 
 	0, 0, {0, 0, 0}};
 
-#define alOut(n, b) YM3812Write(oplChip, n, b, &volume)
+#define alOut(chip, n, b) YM3812Write(chip, n, b, &volume)
 
 //      Register addresses
 // Operator stuff
@@ -61,7 +67,8 @@ static const AlInstrument ChannelRelease = {
 // Global stuff
 #define alEffects 0xbd
 
-static void AlSetChanInst(const AlInstrument *inst, unsigned int chan)
+static void AlSetChanInst(
+	const int chip, const AlInstrument *inst, unsigned int chan)
 {
 	static const uint8_t chanOps[OPL_CHANNELS] = {0,   1,	 2,	   8,	9,
 												  0xA, 0x10, 0x11, 0x12};
@@ -69,35 +76,44 @@ static void AlSetChanInst(const AlInstrument *inst, unsigned int chan)
 
 	m = chanOps[chan]; // modulator cell for channel
 	c = m + 3;		   // carrier cell for channel
-	alOut(m + alChar, inst->mChar);
-	alOut(m + alScale, inst->mScale);
-	alOut(m + alAttack, inst->mAttack);
-	alOut(m + alSus, inst->mSus);
-	alOut(m + alWave, inst->mWave);
-	alOut(c + alChar, inst->cChar);
-	alOut(c + alScale, inst->cScale);
-	alOut(c + alAttack, inst->cAttack);
-	alOut(c + alSus, inst->cSus);
-	alOut(c + alWave, inst->cWave);
-
-	alOut(chan + alFreqL, 0);
-	alOut(chan + alFreqH, 0);
-	alOut(chan + alFeedCon, 0);
+	alOut(chip, m + alChar, inst->mChar);
+	alOut(chip, m + alScale, inst->mScale);
+	alOut(chip, m + alAttack, inst->mAttack);
+	alOut(chip, m + alSus, inst->mSus);
+	alOut(chip, m + alWave, inst->mWave);
+	alOut(chip, c + alChar, inst->cChar);
+	alOut(chip, c + alScale, inst->cScale);
+	alOut(chip, c + alAttack, inst->cAttack);
+	alOut(chip, c + alSus, inst->cSus);
+	alOut(chip, c + alWave, inst->cWave);
+
+	alOut(chip, chan + alFreqL, 0);
+	alOut(chip, chan + alFreqH, 0);
+	alOut(chip, chan + alFeedCon, 0);
 }
 
 bool CWAudioInit(void)
 {
 	// Init adlib
-	if (YM3812Init(1, 3579545, MUSIC_SAMPLE_RATE))
+	if (YM3812Init(OPL_NUM_CHIPS, 3579545, MUSIC_SAMPLE_RATE))
 	{
 		fprintf(stderr, "Unable to create virtual OPL\n");
 		return false;
 	}
+	oplLock = SDL_CreateMutex();
+	if (oplLock == NULL)
+	{
+		fprintf(stderr, "Unable to create OPL lock: %s\n", SDL_GetError());
+		YM3812Shutdown();
+		return false;
+	}
 	return true;
 }
 void CWAudioTerminate(void)
 {
 	YM3812Shutdown();
+	SDL_DestroyMutex(oplLock);
+	oplLock = NULL;
 }
 
 int CWAudioLoadHead(CWAudioHead *head, const char *path)
@@ -126,11 +142,16 @@ int CWAudioLoadHead(CWAudioHead *head, const char *path)
 		goto bail;
 	}
 
-	for (int i = 1; i < 0xf6; i++)
+	SDL_LockMutex(oplLock);
+	for (int chip = 0; chip < OPL_NUM_CHIPS; chip++)
 	{
-		YM3812Write(oplChip, i, 0, &volume);
+		for (int i = 1; i < 0xf6; i++)
+		{
+			YM3812Write(chip, i, 0, &volume);
+		}
+		YM3812Write(chip, 1, 0x20, &volume); // Set WSE=1
 	}
-	YM3812Write(oplChip, 1, 0x20, &volume); // Set WSE=1
+	SDL_UnlockMutex(oplLock);
 
 bail:
 	if (f)
@@ -231,15 +252,31 @@ int CWAudioGetAdlibSound(
 	*len = 0;
 	const char *rawData;
 	size_t rawLen;
-	int err = CWAudioGetAdlibSoundRaw(audio, idx, &rawData, &rawLen);
+	const int err = CWAudioGetAdlibSoundRaw(audio, idx, &rawData, &rawLen);
 	if (err != 0)
 	{
+		return err;
+	}
+	return CWAudioRenderAdlibSound(rawData, rawLen, data, len);
+}
+
+int CWAudioRenderAdlibSound(
+	const char *rawData, const size_t rawLen, char **data, size_t *len)
+{
+	*data = NULL;
+	*len = 0;
+	int err = 0;
+	if (rawLen < sizeof(AdLibSound))
+	{
+		fprintf(stderr, "Adlib sound too short (%d)\n", (int)rawLen);
+		err = -1;
 		goto bail;
 	}
 
+	SDL_LockMutex(oplLock);
 	const AdLibSound *sound = (const AdLibSound *)rawData;
 	const uint8_t alBlock = ((sound->block & 7) << 2) | 0x20;
-	AlSetChanInst(&sound->inst, 0);
+	AlSetChanInst(oplChip, &sound->inst, 0);
 
 	const uint8_t *alSound = sound->data;
 	*len = sound->length * SAMPLES_PER_MUSIC_TICK * SOUND_TICKS *
@@ -252,11 +289,11 @@ int CWAudioGetAdlibSound(
 		// THIS is the way the original Wolfenstein 3-D code handled it!
 		if (*alSound)
 		{
-			alOut(alFreqL, *alSound);
-			alOut(alFreqH, alBlock);
+			alOut(oplChip, alFreqL, *alSound);
+			alOut(oplChip, alFreqH, alBlock);
 		}
 		else
-			alOut(alFreqH, 0);
+			alOut(oplChip, alFreqH, 0);
 		alSound++;
 
 		for (int i = 0; i < SOUND_TICKS; i++)
@@ -265,7 +302,8 @@ int CWAudioGetAdlibSound(
 			stream16 += SAMPLES_PER_MUSIC_TICK * MUSIC_AUDIO_CHANNELS;
 		}
 	}
-	alOut(alFreqH, 0);
+	alOut(oplChip, alFreqH, 0);
+	SDL_UnlockMutex(oplLock);
 
 	return err;
 
@@ -330,9 +368,10 @@ int CWAudioGetMusic(
 			goto bail;
 		}
 
+		SDL_LockMutex(oplLock);
 		for (int i = 0; i < OPL_CHANNELS; i++)
 		{
-			AlSetChanInst(&ChannelRelease, i);
+			AlSetChanInst(oplChip, &ChannelRelease, i);
 		}
 
 		// Measure length of music
@@ -389,7 +428,7 @@ int CWAudioGetMusic(
 					break;
 				sqHackTime = alTimeCount + *(sqHackPtr + 1);
 				alOut(
-					*(const uint8_t *)sqHackPtr,
+					oplChip, *(const uint8_t *)sqHackPtr,
 					*(((const uint8_t *)sqHackPtr) + 1));
 				sqHackPtr += 2;
 				sqHackLen -= 4;
@@ -399,6 +438,7 @@ int CWAudioGetMusic(
 
 			stream16 += SAMPLES_PER_MUSIC_TICK * MUSIC_AUDIO_CHANNELS;
 		}
+		SDL_UnlockMutex(oplLock);
 	}
 
 	return err;
@@ -412,6 +452,104 @@ bail:
 	return err;
 }
 
+static void MusicStreamRestart(CWMusicStream *stream)
+{
+	const uint16_t *sqHack = stream->data;
+	if (*sqHack == 0)
+	{
+		// LumpLength?
+		stream->len = stream->dataLen;
+	}
+	else
+	{
+		stream->len = *sqHack++;
+	}
+	stream->ptr = sqHack;
+	stream->time = 0;
+	stream->timeCount = 0;
+	for (int i = 0; i < OPL_CHANNELS; i++)
+	{
+		AlSetChanInst(oplMusicChip, &ChannelRelease, i);
+	}
+}
+int CWAudioMusicStreamOpen(
+	const CWAudio *audio, const int idx, CWMusicStream **stream)
+{
+	*stream = NULL;
+	const char *rawData;
+	size_t rawLen;
+	const int err = CWAudioGetMusicRaw(audio, idx, &rawData, &rawLen);
+	if (err != 0 || rawLen < sizeof(uint16_t))
+	{
+		return err;
+	}
+	CWMusicStream *s = calloc(1, sizeof *s);
+	// Keep a copy so the stream outlives the audio data
+	s->data = malloc(rawLen);
+	memcpy(s->data, rawData, rawLen);
+	s->dataLen = (int)rawLen;
+	s->tickPos = SAMPLES_PER_MUSIC_TICK;
+	*stream = s;
+	return 0;
+}
+void CWAudioMusicStreamRender(
+	CWMusicStream *stream, int16_t *out, const int frames)
+{
+	SDL_LockMutex(oplLock);
+	if (!stream->started)
+	{
+		MusicStreamRestart(stream);
+		stream->started = true;
+	}
+	for (int remaining = frames; remaining > 0;)
+	{
+		if (stream->tickPos == SAMPLES_PER_MUSIC_TICK)
+		{
+			// Play the commands due on this tick and synthesise it
+			if (stream->len <= 0)
+			{
+				MusicStreamRestart(stream);
+			}
+			while (stream->len > 0)
+			{
+				if (stream->time > stream->timeCount)
+					break;
+				stream->time = stream->timeCount + *(stream->ptr + 1);
+				alOut(
+					oplMusicChip, *(const uint8_t *)stream->ptr,
+					*(((const uint8_t *)stream->ptr) + 1));
+				stream->ptr += 2;
+				stream->len -= 4;
+			}
+			YM3812UpdateOne(
+				oplMusicChip, stream->tick, SAMPLES_PER_MUSIC_TICK);
+			stream->timeCount++;
+			stream->tickPos = 0;
+		}
+		int n = SAMPLES_PER_MUSIC_TICK - stream->tickPos;
+		if (n > remaining)
+		{
+			n = remaining;
+		}
+		memcpy(
+			out, &stream->tick[stream->tickPos * MUSIC_AUDIO_CHANNELS],
+			n * MUSIC_AUDIO_CHANNELS * sizeof(int16_t));
+		out += n * MUSIC_AUDIO_CHANNELS;
+		stream->tickPos += n;
+		remaining -= n;
+	}
+	SDL_UnlockMutex(oplLock);
+}
+void CWAudioMusicStreamFree(CWMusicStream *stream)
+{
+	if (stream == NULL)
+	{
+		return;
+	}
+	free(stream->data);
+	free(stream);
+}
+
 int CWAudioGetLevelMusic(const CWMapType type, const int level)
 {
 	switch (type)
@@ -10,6 +10,8 @@
 #define MUSIC_SAMPLE_RATE 44100
 #define MUSIC_AUDIO_FMT AUDIO_S16SYS
 #define MUSIC_AUDIO_CHANNELS 2
+#define MUSIC_RATE 700
+#define SAMPLES_PER_MUSIC_TICK (MUSIC_SAMPLE_RATE / MUSIC_RATE)
 
 bool CWAudioInit(void);
 void CWAudioTerminate(void);
@@ -26,12 +28,38 @@ int CWAudioGetAdlibSoundRaw(
 	const CWAudio *audio, const int i, const char **data, size_t *len);
 int CWAudioGetAdlibSound(
 	const CWAudio *audio, const int i, char **data, size_t *len);
+// Synthesise raw AdLib sound data, as returned by CWAudioGetAdlibSoundRaw
+int CWAudioRenderAdlibSound(
+	const char *rawData, const size_t rawLen, char **data, size_t *len);
 int CWAudioGetMusicRaw(
 	const CWAudio *audio, const int i, const char **data, size_t *len);
 int CWAudioGetMusic(
 	CWAudio *audio, const CWMapType type, const int idx, char **data,
 	size_t *len);
 
+// IMF music synthesised incrementally, for streaming playback
+typedef struct
+{
+	uint16_t *data;
+	int dataLen;
+	const uint16_t *ptr;
+	int len;
+	int time;
+	int timeCount;
+	bool started;
+	int16_t tick[SAMPLES_PER_MUSIC_TICK * MUSIC_AUDIO_CHANNELS];
+	int tickPos;
+} CWMusicStream;
+// Returns a stream with its own copy of the IMF data, or NULL if the song
+// is empty
+int CWAudioMusicStreamOpen(
+	const CWAudio *audio, const int idx, CWMusicStream **stream);
+// Render frames of 16-bit stereo audio; loops at the end of the song.
+// Safe to call from the audio thread.
+void CWAudioMusicStreamRender(
+	CWMusicStream *stream, int16_t *out, const int frames);
+void CWAudioMusicStreamFree(CWMusicStream *stream);
+
 typedef enum
 {
 	SONG_INTRO,
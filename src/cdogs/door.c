@@ -317,7 +317,7 @@ static TWatch *CreateCloseDoorWatch(
 	a = WatchAddAction(w);
 	a->Type = ACTION_EVENT;
 	a->u.Event = GameEventNew(GAME_EVENT_SOUND_AT);
-	strcpy(a->u.Event.u.SoundAt.Sound, "door_close");
+	a->u.Event.u.SoundAt.Sound = StrSoundId("door_close");
 	a->u.Event.u.SoundAt.Pos = Vec2ToNet(Vec2CenterOfTile(
 		svec2i_add(v, svec2i_scale(dv, (float)doorGroupCount / 2))));
 
@@ -420,7 +420,7 @@ static Trigger *CreateOpenDoorTrigger(
 	a = TriggerAddAction(t);
 	a->Type = ACTION_EVENT;
 	a->u.Event = GameEventNew(GAME_EVENT_SOUND_AT);
-	strcpy(a->u.Event.u.SoundAt.Sound, "door");
+	a->u.Event.u.SoundAt.Sound = StrSoundId("door");
 	a->u.Event.u.SoundAt.Pos = Vec2ToNet(Vec2CenterOfTile(
 		svec2i_add(v, svec2i_scale(dv, (float)doorGroupCount / 2))));
 
@@ -567,6 +567,6 @@ static void DoorDrawPic(
 		svec2i(pic->size.x, pic->size.y - (crop ? dy + bottom : 0)));
 	Rect2i dest = Rect2iNew(svec2i_add(pos, offset), src.Size);
 	TextureRender(
-		pic->Tex, gGraphicsDevice.gameWindow.renderer, src, dest, mask, 0.0,
-		SDL_FLIP_NONE);
+		pic->Tex, gGraphicsDevice.gameWindow.renderer,
+		PicGetTexRect(pic, src), dest, mask, 0.0, SDL_FLIP_NONE);
 }
@@ -60,6 +60,7 @@
 #include "draw/draw.h"
 #include "draw/draw_actor.h"
 #include "draw/drawtools.h"
+#include "draw/floor_chunks.h"
 #include "font.h"
 #include "game_events.h"
 #include "net_util.h"
@@ -69,6 +70,11 @@
 #include "pics.h"
 #include "texture.h"
 
+static ConfigHandle sFogConfig = CONFIG_HANDLE("Game.Fog");
+// Pics drawn every frame
+static PicHandle sObjectiveKillPic = PIC_HANDLE("hud/objective_kill");
+static PicHandle sObjectiveCollectPic = PIC_HANDLE("hud/objective_collect");
+
 // #define DEBUG_DRAW_HITBOXES
 
 // Three types of tile drawing, based on line of sight:
@@ -122,122 +128,150 @@ static void DrawLOSPic(
 
 static void DrawThing(
 	DrawBuffer *b, const Thing *t, const struct vec2i offset);
+static void DrawWall(
+	const Tile *t, const struct vec2i pos, const bool useFog);
+static void DrawObjectiveHighlight(
+	DrawBuffer *b, const struct vec2i offset, const Tile *t, const Thing *ti);
+static void DrawChatter(
+	DrawBuffer *b, const struct vec2i offset, const Tile *t, const Thing *ti,
+	const bool useFog);
+static void DrawPickupMenu(
+	DrawBuffer *b, const TActor *a, const struct vec2i offset);
+static void DrawExtra(
+	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args);
 
-static void DrawTiles(
-	DrawBuffer *b, const struct vec2i offset,
-	void (*drawTileFunc)(
-		DrawBuffer *, const struct vec2i, const Tile *, const struct vec2i,
-		const bool))
+static void AddTileCommands(
+	DrawBuffer *b, const Tile *t, const int row, const struct vec2i pos,
+	const bool drawFloor, const bool hud, const bool useFog);
+void DrawBufferDraw(
+	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args)
 {
-	const bool useFog = ConfigGetBool(&gConfig, "Game.Fog");
+	const bool useFog = ConfigHandleBool(&sFogConfig);
+
+	// Visit each tile once, adding commands for every layer, then sort them
+	// into draw order:
+	// - floor tiles (which do not obstruct anything)
+	// - things that are below everything like debris (wrecks)
+	// - walls and (non-wreck) things in proper order
+	// - things that are above everything
+	// - HUD: objective highlights, actor chatter, actor pickup menus
+	// Floor tiles are drawn from cached chunks if possible
+	const bool drawFloor = !FloorChunksDraw(b, offset, useFog);
+	DrawBufferClearCommands(b);
 	const Tile **tile = DrawBufferGetFirstTile(b);
 	struct vec2i pos;
 	int x, y;
 	for (y = 0, pos.y = b->dy + offset.y; y < Y_TILES;
 		 y++, pos.y += TILE_HEIGHT)
 	{
-		CArrayClear(&b->displaylist);
 		for (x = 0, pos.x = b->dx + offset.x; x < b->Size.x;
 			 x++, tile++, pos.x += TILE_WIDTH)
 		{
 			if (*tile == NULL)
 				continue;
-			drawTileFunc(b, offset, *tile, pos, useFog);
+			AddTileCommands(b, *tile, y, pos, drawFloor, args->HUD, useFog);
 		}
-		DrawBufferSortDisplayList(b);
-		CA_FOREACH(const Thing *, tp, b->displaylist)
-		DrawThing(b, *tp, offset);
-		CA_FOREACH_END()
 		tile += X_TILES - b->Size.x;
 	}
-}
-
-static void DrawFloor(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawWallsAndThings(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawThingsAbove(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawObjectiveHighlights(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawChatters(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawPickupMenus(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog);
-static void DrawExtra(
-	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args);
+	DrawBufferSortCommands(b);
 
-void DrawBufferDraw(
-	DrawBuffer *b, struct vec2i offset, const DrawBufferArgs *args)
-{
-	// First draw the floor tiles (which do not obstruct anything)
-	DrawTiles(b, offset, DrawFloor);
-	// Then draw things that are below everything like debris (wrecks)
-	DrawTiles(b, offset, DrawThingsBelow);
-	// Now draw walls and (non-wreck) things in proper order
-	DrawTiles(b, offset, DrawWallsAndThings);
-	// Draw things that are above everything
-	DrawTiles(b, offset, DrawThingsAbove);
-	if (args->HUD)
+	CA_FOREACH(const DrawCommand, c, b->commands)
+	switch (c->Layer)
 	{
-		// Draw objective highlights, for visible and always-visible objectives
-		DrawTiles(b, offset, DrawObjectiveHighlights);
-		// Draw actor chatter
-		DrawTiles(b, offset, DrawChatters);
-		// Draw actor pickup menus
-		DrawTiles(b, offset, DrawPickupMenus);
+	case DRAW_LAYER_FLOOR:
+		DrawLOSPic(c->Tile, c->Tile->Class->Pic, c->Pos, useFog);
+		break;
+	case DRAW_LAYER_BELOW:
+	case DRAW_LAYER_ABOVE:
+		DrawThing(b, c->Thing, offset);
+		break;
+	case DRAW_LAYER_WALLS_AND_THINGS:
+		if (c->Thing == NULL)
+		{
+			DrawWall(c->Tile, c->Pos, useFog);
+		}
+		else
+		{
+			DrawThing(b, c->Thing, offset);
+		}
+		break;
+	case DRAW_LAYER_OBJECTIVE_HIGHLIGHTS:
+		DrawObjectiveHighlight(b, offset, c->Tile, c->Thing);
+		break;
+	case DRAW_LAYER_CHATTERS:
+		DrawChatter(b, offset, c->Tile, c->Thing, useFog);
+		break;
+	case DRAW_LAYER_PICKUP_MENUS:
+		DrawPickupMenu(b, CArrayGet(&gActors, c->Thing->id), offset);
+		break;
+	default:
+		CASSERT(false, "unknown draw layer");
+		break;
 	}
+	CA_FOREACH_END()
+
 	// Draw editor-only things
 	DrawExtra(b, offset, args);
 }
 
-static void DrawFloor(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void AddTileCommands(
+	DrawBuffer *b, const Tile *t, const int row, const struct vec2i pos,
+	const bool drawFloor, const bool hud, const bool useFog)
 {
-	UNUSED(b);
-	UNUSED(offset);
-	if (t->Class != NULL && t->Class->Pic != NULL &&
+	if (drawFloor && t->Class != NULL && t->Class->Pic != NULL &&
 		t->Class->Pic->Data != NULL && t->Class->Type != TILE_CLASS_WALL)
 	{
-		DrawLOSPic(t, t->Class->Pic, pos, useFog);
+		DrawBufferAddCommand(b, DRAW_LAYER_FLOOR, row, t, NULL, pos, false);
 	}
-}
-
-static void DrawThingsBelow(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
-{
-	UNUSED(pos);
-	UNUSED(offset);
-	UNUSED(useFog);
-	if (t->outOfSight)
+	if (t->Class->Type == TILE_CLASS_WALL ||
+		t->Class->Type == TILE_CLASS_DOOR)
 	{
-		return;
+		DrawBufferAddCommand(
+			b, DRAW_LAYER_WALLS_AND_THINGS, row, t, NULL, pos, false);
 	}
+
 	CA_FOREACH(ThingId, tid, t->things)
 	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti))
+	// Draw the items that are in LOS, sorted by y per row
+	if (!t->outOfSight)
+	{
+		DrawLayer layer = DRAW_LAYER_WALLS_AND_THINGS;
+		if (ThingDrawBelow(ti))
+		{
+			layer = DRAW_LAYER_BELOW;
+		}
+		else if (ThingDrawAbove(ti))
+		{
+			layer = DRAW_LAYER_ABOVE;
+		}
+		DrawBufferAddCommand(b, layer, row, t, ti, pos, true);
+	}
+	if (!hud)
 	{
-		CArrayPushBack(&b->displaylist, &ti);
+		continue;
+	}
+	DrawBufferAddCommand(
+		b, DRAW_LAYER_OBJECTIVE_HIGHLIGHTS, row, t, ti, pos, false);
+	if (ti->kind != KIND_CHARACTER || t->outOfSight)
+	{
+		continue;
+	}
+	const TActor *a = CArrayGet(&gActors, ti->id);
+	if (strlen(a->Chatter) > 0)
+	{
+		DrawBufferAddCommand(b, DRAW_LAYER_CHATTERS, row, t, ti, pos, false);
+	}
+	if (a->pickupMenu.pickup && ActorIsLocalPlayer(a->uid) &&
+		!ColorEquals(GetLOSMask(t, useFog), colorTransparent))
+	{
+		DrawBufferAddCommand(
+			b, DRAW_LAYER_PICKUP_MENUS, row, t, ti, pos, false);
 	}
 	CA_FOREACH_END()
 }
 
-static void DrawWallsAndThings(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawWall(const Tile *t, const struct vec2i pos, const bool useFog)
 {
-	UNUSED(offset);
 	if (t->Class->Type == TILE_CLASS_WALL)
 	{
 		DrawLOSPic(
@@ -252,50 +286,11 @@ static void DrawWallsAndThings(
 			DoorDraw(&t->Door, pos, mask);
 		}
 	}
-
-	// Draw the items that are in LOS
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawBelow(ti) || ThingDrawAbove(ti))
-	{
-		continue;
-	}
-	CArrayPushBack(&b->displaylist, &ti);
-	CA_FOREACH_END()
-}
-
-static void DrawThingsAbove(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
-{
-	UNUSED(offset);
-	UNUSED(pos);
-	UNUSED(useFog);
-	if (t->outOfSight)
-	{
-		return;
-	}
-	CA_FOREACH(ThingId, tid, t->things)
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ThingDrawAbove(ti))
-	{
-		CArrayPushBack(&b->displaylist, &ti);
-	}
-	CA_FOREACH_END()
 }
 
-static void DrawObjectiveHighlights(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawObjectiveHighlight(
+	DrawBuffer *b, const struct vec2i offset, const Tile *t, const Thing *ti)
 {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
-	Thing *ti = ThingIdGetThing(tid);
 	const Pic *pic = NULL;
 	color_t color = colorWhite;
 	struct vec2i drawOffsetExtra = svec2i_zero();
@@ -308,25 +303,25 @@ static void DrawObjectiveHighlights(
 			CArrayGet(&gMission.missionData->Objectives, objective);
 		if (o->Flags & OBJECTIVE_HIDDEN)
 		{
-			continue;
+			return;
 		}
 		if (!(o->Flags & OBJECTIVE_POSKNOWN) && t->outOfSight)
 		{
-			continue;
+			return;
 		}
 		switch (o->Type)
 		{
 		case OBJECTIVE_KILL:
 		case OBJECTIVE_DESTROY: // fallthrough
-			pic = PicManagerGetPic(&gPicManager, "hud/objective_kill");
+			pic = PicHandleGet(&sObjectiveKillPic);
 			break;
 		case OBJECTIVE_RESCUE:
 		case OBJECTIVE_COLLECT: // fallthrough
-			pic = PicManagerGetPic(&gPicManager, "hud/objective_collect");
+			pic = PicHandleGet(&sObjectiveCollectPic);
 			break;
 		default:
 			CASSERT(false, "unexpected objective to draw");
-			continue;
+			return;
 		}
 		color = o->color;
 		if (ti->kind == KIND_CHARACTER)
@@ -339,13 +334,13 @@ static void DrawObjectiveHighlights(
 		// Require LOS for non-deathmatch modes
 		if (!IsPVP(gCampaign.Entry.Mode) && t->outOfSight)
 		{
-			continue;
+			return;
 		}
 		// Gun pickup or keycard
 		const Pickup *p = CArrayGet(&gPickups, ti->id);
 		if (!PickupClassHasKeyEffect(p->class) && !PickupIsManual(NULL, p))
 		{
-			continue;
+			return;
 		}
 		pic = CPicGetPic(&p->thing.CPic, 0);
 		color = colorDarker;
@@ -365,73 +360,23 @@ static void DrawObjectiveHighlights(
 			svec2i_add(picPos, svec2i_add(drawOffset, drawOffsetExtra)), color,
 			0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
 	}
-	CA_FOREACH_END()
 }
 
 #define ACTOR_HEIGHT 25
-static void DrawChatters(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
+static void DrawChatter(
+	DrawBuffer *b, const struct vec2i offset, const Tile *t, const Thing *ti,
+	const bool useFog)
 {
-	UNUSED(pos);
-	UNUSED(useFog);
-	CA_FOREACH(ThingId, tid, t->things)
-	// Draw the items that are in LOS
-	if (t->outOfSight)
-	{
-		continue;
-	}
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ti->kind != KIND_CHARACTER)
-	{
-		continue;
-	}
-
 	const TActor *a = CArrayGet(&gActors, ti->id);
 	// Draw character text
-	if (strlen(a->Chatter) > 0)
-	{
-		const struct vec2i textPos = svec2i(
-			(int)a->thing.Pos.x - b->xTop + offset.x -
-				FontStrW(a->Chatter) / 2,
-			(int)a->thing.Pos.y - b->yTop + offset.y - ACTOR_HEIGHT);
-		const color_t mask = GetLOSMask(t, useFog);
-		if (!ColorEquals(mask, colorTransparent))
-		{
-			FontStrMask(a->Chatter, textPos, mask);
-		}
-	}
-	CA_FOREACH_END()
-}
-
-static void DrawPickupMenu(
-	DrawBuffer *b, const TActor *a, const struct vec2i offset);
-static void DrawPickupMenus(
-	DrawBuffer *b, const struct vec2i offset, const Tile *t,
-	const struct vec2i pos, const bool useFog)
-{
-	UNUSED(pos);
-	CA_FOREACH(ThingId, tid, t->things)
-	// Draw the items that are in LOS
-	if (t->outOfSight || ColorEquals(GetLOSMask(t, useFog), colorTransparent))
-	{
-		continue;
-	}
-	const Thing *ti = ThingIdGetThing(tid);
-	if (ti->kind != KIND_CHARACTER)
-	{
-		continue;
-	}
-
-	const TActor *a = CArrayGet(&gActors, ti->id);
-	// Draw pickup menu
-	if (!a->pickupMenu.pickup || !ActorIsLocalPlayer(a->uid))
+	const struct vec2i textPos = svec2i(
+		(int)a->thing.Pos.x - b->xTop + offset.x - FontStrW(a->Chatter) / 2,
+		(int)a->thing.Pos.y - b->yTop + offset.y - ACTOR_HEIGHT);
+	const color_t mask = GetLOSMask(t, useFog);
+	if (!ColorEquals(mask, colorTransparent))
 	{
-		continue;
+		FontStrMask(a->Chatter, textPos, mask);
 	}
-
-	DrawPickupMenu(b, a, offset);
-	CA_FOREACH_END()
 }
 static void DrawPickupMenu(
 	DrawBuffer *b, const TActor *a, const struct vec2i offset)
@@ -689,7 +634,8 @@ static void DrawGuideImage(
 	color_t mask = colorWhite;
 	mask.a = alpha;
 	TextureRender(
-		guideImage->Tex, gGraphicsDevice.gameWindow.renderer, Rect2iZero(),
+		guideImage->Tex, gGraphicsDevice.gameWindow.renderer,
+		PicGetTexRect(guideImage, Rect2iZero()),
 		Rect2iNew(
 			pos, svec2i(
 					 (mint_t)MROUND(guideImage->size.x * xScale),
@@ -66,6 +66,8 @@
 #include "pic_manager.h"
 #include "pics.h"
 
+static ConfigHandle sLaserSightConfig = CONFIG_HANDLE("Game.LaserSight");
+
 #define TRANSPARENT_ACTOR_ALPHA 64
 
 static struct vec2i GetActorDrawOffset(
@@ -95,6 +97,230 @@ static struct vec2i GetActorDrawOffset(
 	return offset;
 }
 
+static const Pic *SpritesGetPic(const NamedSprites *ns, const int idx)
+{
+	if (ns == NULL)
+	{
+		return NULL;
+	}
+	return CArrayGet(&ns->pics, idx);
+}
+static int GetHeadPicIndex(const direction_e dir, const bool isGrimacing)
+{
+	// If firing, draw the firing head pic
+	const int row = isGrimacing ? 1 : 0;
+	return (int)dir + row * 8;
+}
+static int GetBodyPicIndex(
+	const direction_e dir, const ActorAnimation anim, const int frame)
+{
+	const int stride = anim == ACTORANIMATION_WALKING ? 8 : 1;
+	const int col = frame % stride;
+	const int row = (int)dir;
+	return col + row * stride;
+}
+static bool IsBarrelFiring(const gunstate_e barrelState)
+{
+	return barrelState == GUNSTATE_FIRING || barrelState == GUNSTATE_RECOIL;
+}
+
+static NamedSprites *GetHeadSprites(
+	const CharacterClass *c, const CharColors *colors)
+{
+	if (strlen(c->HeadSprites) == 0)
+	{
+		return NULL;
+	}
+	// Get or generate masked sprites
+	return PicManagerGetCharSprites(&gPicManager, c->HeadSprites, colors);
+}
+static NamedSprites *GetHeadPartSprites(
+	const char *name, const HeadPart hp, const CharColors *colors)
+{
+	if (name == NULL)
+	{
+		return NULL;
+	}
+	// Get or generate masked sprites
+	char buf[CDOGS_PATH_MAX];
+	const char *subpaths[] = {"hairs", "facehairs", "hats", "glasses"};
+	sprintf(buf, "chars/%s/%s", subpaths[hp], name);
+	return PicManagerGetCharSprites(&gPicManager, buf, colors);
+}
+const Pic *GetHeadPic(
+	const CharacterClass *c, const direction_e dir, const bool isGrimacing,
+	const CharColors *colors)
+{
+	return SpritesGetPic(
+		GetHeadSprites(c, colors), GetHeadPicIndex(dir, isGrimacing));
+}
+const Pic *GetHeadPartPic(
+	const char *name, const HeadPart hp, const direction_e dir,
+	const bool isGrimacing, const CharColors *colors)
+{
+	return SpritesGetPic(
+		GetHeadPartSprites(name, hp, colors),
+		GetHeadPicIndex(dir, isGrimacing));
+}
+static NamedSprites *GetBodySprites(
+	PicManager *pm, const CharSprites *cs, const ActorAnimation anim,
+	const int numBarrels, const int grips, const gunstate_e barrelState,
+	const CharColors *colors)
+{
+	char buf[CDOGS_PATH_MAX];
+	CASSERT(numBarrels <= 2, "up to 2 barrels supported");
+	NamedSprites *ns = NULL;
+	const char *upperPose = "";
+	if (numBarrels == 1)
+	{
+		upperPose = "_handgun";
+	}
+	if (numBarrels == 2)
+	{
+		upperPose = "_dualgun";
+	}
+	if (grips == 2)
+	{
+		upperPose = "_rifle";
+		if (IsBarrelFiring(barrelState))
+		{
+			upperPose = "_riflefire";
+		}
+	}
+	for (;;)
+	{
+		sprintf(
+			buf, "chars/bodies/%s/upper_%s%s", cs->Name,
+			anim == ACTORANIMATION_WALKING ? "run" : "idle",
+			upperPose); // TODO: other gun holding poses
+		// Get or generate masked sprites
+		ns = PicManagerGetCharSprites(pm, buf, colors);
+		// TODO: provide dualgun sprites for all body types
+		if (ns == NULL && strcmp(upperPose, "_handgun") != 0)
+		{
+			upperPose = "_handgun";
+			continue;
+		}
+		break;
+	}
+	return ns;
+}
+static NamedSprites *GetLegsSprites(
+	PicManager *pm, const CharSprites *cs, const ActorAnimation anim,
+	const CharColors *colors)
+{
+	char buf[CDOGS_PATH_MAX];
+	sprintf(
+		buf, "chars/bodies/%s/legs_%s", cs->Name,
+		anim == ACTORANIMATION_WALKING ? "run" : "idle");
+	// Get or generate masked sprites
+	return PicManagerGetCharSprites(pm, buf, colors);
+}
+static int GetGunPicIndex(const direction_e dir, const int gunState)
+{
+	return (gunState == GUNSTATE_READY ? 8 : 0) + dir;
+}
+
+static bool ActorSpritesIsValid(
+	const ActorSprites *s, const Character *c, const WeaponClass *gun,
+	const CharColors *colors)
+{
+	if (!s->IsValid || s->Generation != gPicManager.maskedGeneration ||
+		s->Class != c->Class || s->Gun != gun ||
+		memcmp(&s->Colors, colors, sizeof s->Colors) != 0)
+	{
+		return false;
+	}
+	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
+	{
+		if (s->HeadPartNames[hp] != c->HeadParts[hp])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+static void ActorSpritesResolve(
+	ActorSprites *s, const Character *c, const WeaponClass *gun,
+	const CharColors *colors)
+{
+	memset(s, 0, sizeof *s);
+	s->Class = c->Class;
+	memcpy(s->HeadPartNames, c->HeadParts, sizeof s->HeadPartNames);
+	s->Colors = *colors;
+	s->Gun = gun;
+
+	PicManager *pm = &gPicManager;
+	const CharSprites *cs = c->Class->Sprites;
+	s->Head = GetHeadSprites(c->Class, colors);
+	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
+	{
+		if (c->Class->HasHeadParts[hp])
+		{
+			s->HeadParts[hp] =
+				GetHeadPartSprites(c->HeadParts[hp], hp, colors);
+		}
+	}
+	const int numBarrels =
+		(gun == NULL || WC_BARREL_ATTR(*gun, Sprites, 0) == NULL)
+			? 0
+			: WeaponClassNumBarrels(gun);
+	const int grips = gun == NULL ? 0 : WC_BARREL_ATTR(*gun, Grips, 0);
+	for (int walking = 0; walking < 2; walking++)
+	{
+		const ActorAnimation anim =
+			walking ? ACTORANIMATION_WALKING : ACTORANIMATION_IDLE;
+		s->Body[walking][0] = GetBodySprites(
+			pm, cs, anim, numBarrels, grips, GUNSTATE_READY, colors);
+		s->Body[walking][1] = GetBodySprites(
+			pm, cs, anim, numBarrels, grips, GUNSTATE_FIRING, colors);
+		s->Legs[walking] = GetLegsSprites(pm, cs, anim, colors);
+	}
+	for (int i = 0; i < numBarrels; i++)
+	{
+		s->Guns[i] = PicManagerGetCharSprites(
+			pm, WC_BARREL_ATTR(*gun, Sprites, i), colors);
+	}
+	s->Death = CharacterClassGetDeathSprites(c->Class, pm);
+
+	// Resolving may have generated sprites; note the generation afterwards
+	s->Generation = pm->maskedGeneration;
+	s->IsValid = true;
+}
+static const ActorSprites *GetActorSprites(
+	const TActor *a, const Character *c, const WeaponClass *gun,
+	const CharColors *colors)
+{
+	if (c->Class == NULL)
+	{
+		return NULL;
+	}
+	ActorSprites *s = CArrayGet(&gActorSprites, a->thing.id);
+	if (!ActorSpritesIsValid(s, c, gun, colors))
+	{
+		ActorSpritesResolve(s, c, gun, colors);
+		return s;
+	}
+	// Keep the cached sprites from being evicted
+	PicManager *pm = &gPicManager;
+	PicManagerTouchCharSprites(pm, s->Head);
+	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
+	{
+		PicManagerTouchCharSprites(pm, s->HeadParts[hp]);
+	}
+	for (int walking = 0; walking < 2; walking++)
+	{
+		PicManagerTouchCharSprites(pm, s->Body[walking][0]);
+		PicManagerTouchCharSprites(pm, s->Body[walking][1]);
+		PicManagerTouchCharSprites(pm, s->Legs[walking]);
+	}
+	for (int i = 0; i < MAX_BARRELS; i++)
+	{
+		PicManagerTouchCharSprites(pm, s->Guns[i]);
+	}
+	return s;
+}
+
 static direction_e GetLegDirAndFrame(
 	const TActor *a, const direction_e bodyDir, int *frame);
 static ActorPics GetUnorderedPics(
@@ -102,7 +328,7 @@ static ActorPics GetUnorderedPics(
 	const ActorAnimation anim, const int frame, const WeaponClass *gun,
 	const gunstate_e barrelStates[MAX_BARRELS], const bool isGrimacing,
 	const color_t shadowMask, const color_t *mask, const CharColors *colors,
-	const int deadPic);
+	const int deadPic, const ActorSprites *sprites);
 static void UpdatePilotHeadPic(
 	ActorPics *pics, const TActor *a, const direction_e dir);
 static void ReorderPics(
@@ -177,9 +403,11 @@ ActorPics GetCharacterPicsFromActor(const TActor *a)
 		gunStates[i] = gun->barrels[i].state;
 	}
 
+	const ActorSprites *sprites = GetActorSprites(
+		a, c, gun->Gun, colors != NULL ? colors : &c->Colors);
 	ActorPics pics = GetUnorderedPics(
 		c, dir, legDir, a->anim.Type, frame, gun->Gun, gunStates,
-		ActorIsGrimacing(a), shadowMask, maskP, colors, a->dead);
+		ActorIsGrimacing(a), shadowMask, maskP, colors, a->dead, sprites);
 	UpdatePilotHeadPic(&pics, a, dir);
 	ReorderPics(&pics, c, dir, gun->Gun, gunStates);
 	return pics;
@@ -199,16 +427,18 @@ static void UpdatePilotHeadPic(
 		return;
 	}
 	const Character *c = ActorGetCharacter(pilot);
-	const bool grimace = ActorIsGrimacing(a);
-	pics->Head = GetHeadPic(c->Class, dir, grimace, &c->Colors);
+	const ActorSprites *sprites = GetActorSprites(
+		pilot, c, ACTOR_GET_WEAPON(pilot)->Gun, &c->Colors);
+	if (sprites == NULL)
+	{
+		return;
+	}
+	const int idx = GetHeadPicIndex(dir, ActorIsGrimacing(a));
+	pics->Head = SpritesGetPic(sprites->Head, idx);
 
 	for (HeadPart hp = HEAD_PART_HAIR; hp < HEAD_PART_COUNT; hp++)
 	{
-		if (c->Class->HasHeadParts[hp])
-		{
-			pics->HeadParts[hp] =
-				GetHeadPartPic(c->HeadParts[hp], hp, dir, grimace, &c->Colors);
-		}
+		pics->HeadParts[hp] = SpritesGetPic(sprites->HeadParts[hp], idx);
 	}
 }
 ActorPics GetCharacterPics(
@@ -220,28 +450,18 @@ ActorPics GetCharacterPics(
 {
 	ActorPics pics = GetUnorderedPics(
 		c, dir, legDir, anim, frame, gun, barrelStates, isGrimacing,
-		shadowMask, mask, colors, deadPic);
+		shadowMask, mask, colors, deadPic, NULL);
 
 	ReorderPics(&pics, c, dir, gun, barrelStates);
 
 	return pics;
 }
-static const Pic *GetBodyPic(
-	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const int numBarrels,
-	const int grips, const gunstate_e barrelState, const CharColors *colors);
-static const Pic *GetLegsPic(
-	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const CharColors *colors);
-static const Pic *GetGunPic(
-	PicManager *pm, const char *gunSprites, const direction_e dir,
-	const int gunState, const CharColors *colors);
 static ActorPics GetUnorderedPics(
 	const Character *c, const direction_e dir, const direction_e legDir,
 	const ActorAnimation anim, const int frame, const WeaponClass *gun,
 	const gunstate_e barrelStates[MAX_BARRELS], const bool isGrimacing,
 	const color_t shadowMask, const color_t *mask, const CharColors *colors,
-	const int deadPic)
+	const int deadPic, const ActorSprites *sprites)
 {
 	ActorPics pics;
 	memset(&pics, 0, sizeof pics);
@@ -273,7 +493,9 @@ static ActorPics GetUnorderedPics(
 	if (pics.IsDead)
 	{
 		const NamedSprites *deathSprites =
-			CharacterClassGetDeathSprites(c->Class, &gPicManager);
+			sprites != NULL
+				? sprites->Death
+				: CharacterClassGetDeathSprites(c->Class, &gPicManager);
 		if (deadPic - 1 < (int)deathSprites->pics.size)
 		{
 			pics.IsDying = true;
@@ -313,7 +535,10 @@ static ActorPics GetUnorderedPics(
 		}
 	}
 	const int grips = gun == NULL ? 0 : WC_BARREL_ATTR(*gun, Grips, 0);
-	pics.Head = GetHeadPic(c->Class, headDir, grimace, colors);
+	const int headIdx = GetHeadPicIndex(headDir, grimace);
+	pics.Head = SpritesGetPic(
+		sprites != NULL ? sprites->Head : GetHeadSprites(c->Class, colors),
+		headIdx);
 	pics.HeadOffset = GetActorDrawOffset(
 		pics.Head, BODY_PART_HEAD, c->Class->Sprites, anim, frame, dir,
 		GUNSTATE_READY);
@@ -322,8 +547,11 @@ static ActorPics GetUnorderedPics(
 	{
 		if (c->Class->HasHeadParts[hp])
 		{
-			pics.HeadParts[hp] =
-				GetHeadPartPic(c->HeadParts[hp], hp, headDir, grimace, colors);
+			pics.HeadParts[hp] = SpritesGetPic(
+				sprites != NULL
+					? sprites->HeadParts[hp]
+					: GetHeadPartSprites(c->HeadParts[hp], hp, colors),
+				headIdx);
 			pics.HeadPartOffsets[hp] = GetActorDrawOffset(
 				pics.HeadParts[hp], BODY_PART_HEAD, c->Class->Sprites, anim,
 				frame, dir, GUNSTATE_READY);
@@ -333,9 +561,12 @@ static ActorPics GetUnorderedPics(
 	// Gun
 	for (int i = 0; i < numBarrels; i++)
 	{
-		pics.Guns[i] = GetGunPic(
-			&gPicManager, WC_BARREL_ATTR(*gun, Sprites, i), dir,
-			barrelStates[i], colors);
+		pics.Guns[i] = SpritesGetPic(
+			sprites != NULL ? sprites->Guns[i]
+							: PicManagerGetCharSprites(
+								  &gPicManager,
+								  WC_BARREL_ATTR(*gun, Sprites, i), colors),
+			GetGunPicIndex(dir, barrelStates[i]));
 		if (pics.Guns[i] != NULL)
 		{
 			pics.GunOffsets[i] = GetActorDrawOffset(
@@ -352,16 +583,30 @@ static ActorPics GetUnorderedPics(
 	}
 
 	// Body
-	pics.Body = GetBodyPic(
-		&gPicManager, c->Class->Sprites, dir, anim, frame, numBarrels, grips,
-		barrelStates[0], colors);
+	const NamedSprites *bodySprites;
+	const NamedSprites *legsSprites;
+	if (sprites != NULL)
+	{
+		const int walking = anim == ACTORANIMATION_WALKING;
+		bodySprites = sprites->Body[walking][IsBarrelFiring(barrelStates[0])];
+		legsSprites = sprites->Legs[walking];
+	}
+	else
+	{
+		bodySprites = GetBodySprites(
+			&gPicManager, c->Class->Sprites, anim, numBarrels, grips,
+			barrelStates[0], colors);
+		legsSprites =
+			GetLegsSprites(&gPicManager, c->Class->Sprites, anim, colors);
+	}
+	pics.Body = SpritesGetPic(bodySprites, GetBodyPicIndex(dir, anim, frame));
 	pics.BodyOffset = GetActorDrawOffset(
 		pics.Body, BODY_PART_BODY, c->Class->Sprites, anim, frame, dir,
 		GUNSTATE_READY);
 
 	// Legs
-	pics.Legs = GetLegsPic(
-		&gPicManager, c->Class->Sprites, legDir, anim, frame, colors);
+	pics.Legs =
+		SpritesGetPic(legsSprites, GetBodyPicIndex(legDir, anim, frame));
 	pics.LegsOffset = GetActorDrawOffset(
 		pics.Legs, BODY_PART_LEGS, c->Class->Sprites, anim, frame, legDir,
 		GUNSTATE_READY);
@@ -496,7 +741,7 @@ void DrawLaserSight(
 	if (pics->IsDead || ColorEquals(pics->ShadowMask, colorTransparent))
 		return;
 	// Check config
-	const LaserSight ls = ConfigGetEnum(&gConfig, "Game.LaserSight");
+	const LaserSight ls = ConfigHandleEnum(&sLaserSightConfig);
 	if (ls != LASER_SIGHT_ALL &&
 		!(ls == LASER_SIGHT_PLAYERS && a->PlayerUID >= 0))
 	{
@@ -546,121 +791,6 @@ static void DrawLaserSightSingle(
 	DrawLine(from, to, color);
 }
 
-const Pic *GetHeadPic(
-	const CharacterClass *c, const direction_e dir, const bool isGrimacing,
-	const CharColors *colors)
-{
-	if (strlen(c->HeadSprites) == 0)
-	{
-		return NULL;
-	}
-	// If firing, draw the firing head pic
-	const int row = isGrimacing ? 1 : 0;
-	const int idx = (int)dir + row * 8;
-	// Get or generate masked sprites
-	const NamedSprites *ns =
-		PicManagerGetCharSprites(&gPicManager, c->HeadSprites, colors);
-	return CArrayGet(&ns->pics, idx);
-}
-const Pic *GetHeadPartPic(
-	const char *name, const HeadPart hp, const direction_e dir,
-	const bool isGrimacing, const CharColors *colors)
-{
-	if (name == NULL)
-	{
-		return NULL;
-	}
-	const int row = isGrimacing ? 1 : 0;
-	const int idx = (int)dir + row * 8;
-	// Get or generate masked sprites
-	char buf[CDOGS_PATH_MAX];
-	const char *subpaths[] = {"hairs", "facehairs", "hats", "glasses"};
-	sprintf(buf, "chars/%s/%s", subpaths[hp], name);
-	const NamedSprites *ns =
-		PicManagerGetCharSprites(&gPicManager, buf, colors);
-	if (ns == NULL)
-	{
-		return NULL;
-	}
-	return CArrayGet(&ns->pics, idx);
-}
-static const Pic *GetBodyPic(
-	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const int numBarrels,
-	const int grips, const gunstate_e barrelState, const CharColors *colors)
-{
-	const int stride = anim == ACTORANIMATION_WALKING ? 8 : 1;
-	const int col = frame % stride;
-	const int row = (int)dir;
-	const int idx = col + row * stride;
-	char buf[CDOGS_PATH_MAX];
-	CASSERT(numBarrels <= 2, "up to 2 barrels supported");
-	const NamedSprites *ns = NULL;
-	const char *upperPose = "";
-	if (numBarrels == 1)
-	{
-		upperPose = "_handgun";
-	}
-	if (numBarrels == 2)
-	{
-		upperPose = "_dualgun";
-	}
-	if (grips == 2)
-	{
-		upperPose = "_rifle";
-		if (barrelState == GUNSTATE_FIRING || barrelState == GUNSTATE_RECOIL)
-		{
-			upperPose = "_riflefire";
-		}
-	}
-	for (;;)
-	{
-		sprintf(
-			buf, "chars/bodies/%s/upper_%s%s", cs->Name,
-			anim == ACTORANIMATION_WALKING ? "run" : "idle",
-			upperPose); // TODO: other gun holding poses
-		// Get or generate masked sprites
-		ns = PicManagerGetCharSprites(pm, buf, colors);
-		// TODO: provide dualgun sprites for all body types
-		if (ns == NULL && strcmp(upperPose, "_handgun") != 0)
-		{
-			upperPose = "_handgun";
-			continue;
-		}
-		break;
-	}
-	return CArrayGet(&ns->pics, idx);
-}
-static const Pic *GetLegsPic(
-	PicManager *pm, const CharSprites *cs, const direction_e dir,
-	const ActorAnimation anim, const int frame, const CharColors *colors)
-{
-	const int stride = anim == ACTORANIMATION_WALKING ? 8 : 1;
-	const int col = frame % stride;
-	const int row = (int)dir;
-	const int idx = col + row * stride;
-	char buf[CDOGS_PATH_MAX];
-	sprintf(
-		buf, "chars/bodies/%s/legs_%s", cs->Name,
-		anim == ACTORANIMATION_WALKING ? "run" : "idle");
-	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetCharSprites(pm, buf, colors);
-	return CArrayGet(&ns->pics, idx);
-}
-static const Pic *GetGunPic(
-	PicManager *pm, const char *gunSprites, const direction_e dir,
-	const int gunState, const CharColors *colors)
-{
-	const int idx = (gunState == GUNSTATE_READY ? 8 : 0) + dir;
-	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetCharSprites(pm, gunSprites, colors);
-	if (ns == NULL)
-	{
-		return NULL;
-	}
-	return CArrayGet(&ns->pics, idx);
-}
-
 void DrawCharacterSimple(
 	const Character *c, const struct vec2i pos, const direction_e d,
 	const bool hilite, const bool showGun, const WeaponClass *gun)
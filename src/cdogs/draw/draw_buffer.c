@@ -49,6 +49,7 @@
 #include "draw/draw_buffer.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "algorithms.h"
 #include "log.h"
@@ -60,13 +61,16 @@ void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g)
 	b->OrigSize = size;
 	CArrayInitFillZero(&b->tiles, sizeof(Tile *), size.x * size.y);
 	b->g = g;
-	CArrayInit(&b->displaylist, sizeof(const Thing *));
-	CArrayReserve(&b->displaylist, 32);
+	CArrayInit(&b->commands, sizeof(DrawCommand));
+	CArrayReserve(&b->commands, size.x * size.y * 2);
+	CArrayInit(&b->commandsSorted, sizeof(DrawCommand));
+	CArrayReserve(&b->commandsSorted, size.x * size.y * 2);
 }
 void DrawBufferTerminate(DrawBuffer *b)
 {
 	CArrayTerminate(&b->tiles);
-	CArrayTerminate(&b->displaylist);
+	CArrayTerminate(&b->commands);
+	CArrayTerminate(&b->commandsSorted);
 }
 
 void DrawBufferSetFromMap(
@@ -133,28 +137,89 @@ void DrawBufferFix(DrawBuffer *buffer)
 	}
 }
 
-static int CompareY(const void *v1, const void *v2);
-void DrawBufferSortDisplayList(DrawBuffer *buffer)
+void DrawBufferClearCommands(DrawBuffer *b)
 {
-	qsort(
-		buffer->displaylist.data,
-		buffer->displaylist.size,
-		buffer->displaylist.elemSize,
-		CompareY);
+	CArrayClear(&b->commands);
 }
-static int CompareY(const void *v1, const void *v2)
+
+// Map non-negative floats to integers with the same order
+static uint32_t FloatSortKey(const float f)
+{
+	if (!(f > 0))
+	{
+		return 0;
+	}
+	uint32_t u;
+	memcpy(&u, &f, sizeof u);
+	return u;
+}
+void DrawBufferAddCommand(
+	DrawBuffer *b, const DrawLayer layer, const int row, const Tile *t,
+	const Thing *ti, const struct vec2i pos, const bool sortY)
+{
+	DrawCommand c;
+	c.Key = ((uint64_t)layer << 56) | ((uint64_t)(row & 0xffff) << 40);
+	if (sortY)
+	{
+		c.Key |= ((uint64_t)1 << 32) | FloatSortKey(ti->Pos.y);
+	}
+	c.Layer = layer;
+	c.Tile = t;
+	c.Thing = ti;
+	c.Pos = pos;
+	CArrayPushBack(&b->commands, &c);
+}
+
+// LSD radix sort, one byte at a time; stable, so commands with equal keys
+// stay in the order they were added
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+void DrawBufferSortCommands(DrawBuffer *b)
 {
-	const Thing * const *t1 = v1;
-	const Thing * const *t2 = v2;
-	if ((*t1)->Pos.y < (*t2)->Pos.y)
+	const size_t n = b->commands.size;
+	if (n < 2)
 	{
-		return -1;
+		return;
 	}
-	else if ((*t1)->Pos.y > (*t2)->Pos.y)
+	CArrayResize(&b->commandsSorted, n, NULL);
+	size_t counts[RADIX_PASSES][RADIX_BUCKETS];
+	memset(counts, 0, sizeof counts);
+	const DrawCommand *cmds = b->commands.data;
+	for (size_t i = 0; i < n; i++)
 	{
-		return 1;
+		for (int p = 0; p < RADIX_PASSES; p++)
+		{
+			counts[p][(cmds[i].Key >> (p * RADIX_BITS)) & 0xff]++;
+		}
+	}
+	for (int p = 0; p < RADIX_PASSES; p++)
+	{
+		// Skip bytes that are the same for all keys
+		const int shift = p * RADIX_BITS;
+		if (counts[p][(cmds[0].Key >> shift) & 0xff] == n)
+		{
+			continue;
+		}
+		size_t offsets[RADIX_BUCKETS];
+		size_t total = 0;
+		for (int i = 0; i < RADIX_BUCKETS; i++)
+		{
+			offsets[i] = total;
+			total += counts[p][i];
+		}
+		const DrawCommand *src = b->commands.data;
+		DrawCommand *dst = b->commandsSorted.data;
+		for (size_t i = 0; i < n; i++)
+		{
+			dst[offsets[(src[i].Key >> shift) & 0xff]++] = src[i];
+		}
+		// Swap buffers so the sorted commands are in b->commands
+		const CArray tmp = b->commands;
+		b->commands = b->commandsSorted;
+		b->commandsSorted = tmp;
+		cmds = b->commands.data;
 	}
-	return 0;
 }
 
 const Tile **DrawBufferGetFirstTile(const DrawBuffer *b)
@@ -48,8 +48,32 @@
 */
 #pragma once
 
+#include <stdint.h>
+
 #include "map.h"
 
+// Layers in the order they are drawn
+typedef enum
+{
+	DRAW_LAYER_FLOOR,
+	DRAW_LAYER_BELOW,
+	DRAW_LAYER_WALLS_AND_THINGS,
+	DRAW_LAYER_ABOVE,
+	DRAW_LAYER_OBJECTIVE_HIGHLIGHTS,
+	DRAW_LAYER_CHATTERS,
+	DRAW_LAYER_PICKUP_MENUS
+} DrawLayer;
+
+typedef struct
+{
+	// Sorted by layer, tile row, then y for things sorted by y
+	uint64_t Key;
+	DrawLayer Layer;
+	const Tile *Tile;
+	const Thing *Thing; // NULL for tile commands
+	struct vec2i Pos;	// screen position of the tile
+} DrawCommand;
+
 typedef struct
 {
 	GraphicsDevice *g;
@@ -59,7 +83,8 @@ typedef struct
 	struct vec2i OrigSize;
 	struct vec2i Size;	// size in tiles
 	CArray tiles;	// of Tile *
-	CArray displaylist;	// of const Thing *, to determine draw order
+	CArray commands;	// of DrawCommand, to determine draw order
+	CArray commandsSorted;	// of DrawCommand, scratch space for sorting
 } DrawBuffer;
 
 void DrawBufferInit(DrawBuffer *b, struct vec2i size, GraphicsDevice *g);
@@ -69,5 +94,12 @@ void DrawBufferSetFromMap(
 	DrawBuffer *buffer, const Map *map, const struct vec2 origin,
 	const int width);
 void DrawBufferFix(DrawBuffer *buffer);
-void DrawBufferSortDisplayList(DrawBuffer *buffer);
+void DrawBufferClearCommands(DrawBuffer *b);
+// Add a draw command; commands in the same layer and row are drawn in the
+// order they are added, except sortY ones which are drawn afterwards by y
+void DrawBufferAddCommand(
+	DrawBuffer *b, const DrawLayer layer, const int row, const Tile *t,
+	const Thing *ti, const struct vec2i pos, const bool sortY);
+// Stable sort of commands into draw order
+void DrawBufferSortCommands(DrawBuffer *b);
 const Tile **DrawBufferGetFirstTile(const DrawBuffer *b);
@@ -58,6 +58,8 @@
 #include "blit.h"
 #include "grafx.h"
 
+static ConfigHandle sShadowsConfig = CONFIG_HANDLE("Graphics.Shadows");
+
 
 void DrawPoint(const struct vec2i pos, const color_t c)
 {
@@ -219,12 +221,13 @@ void DrawShadow(
 	GraphicsDevice *g, const struct vec2i pos, const struct vec2 scale,
 	const color_t mask)
 {
-	if (!ConfigGetBool(&gConfig, "Graphics.Shadows") ||
+	if (!ConfigHandleBool(&sShadowsConfig) ||
 		ColorEquals(mask, colorTransparent))
 	{
 		return;
 	}
-	const Pic *shadow = PicManagerGetPic(&gPicManager, "particles/shadow");
+	static PicHandle shadowPic = PIC_HANDLE("particles/shadow");
+	const Pic *shadow = PicHandleGet(&shadowPic);
 	const struct vec2 drawScale =
 		svec2_divide(svec2_scale(scale, 2), svec2_assign_vec2i(shadow->size));
 	const struct vec2i drawPos = svec2i_subtract(pos, svec2i_assign_vec2(scale));
@@ -0,0 +1,372 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "draw/floor_chunks.h"
+
+#include <string.h>
+
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+// Limit on chunk textures, to bound video memory on large maps; enough to
+// cover four split screen views
+#define FLOOR_CHUNK_TEXTURES_MAX 64
+
+typedef struct
+{
+	SDL_Texture *tex;
+	uint64_t lastUsed;	// draw count when the chunk was last drawn
+	// Tile classes the chunk was drawn with, to detect changed tiles
+	const TileClass *classes[FLOOR_CHUNK_SIZE * FLOOR_CHUNK_SIZE];
+	bool isDirty;
+} FloorChunk;
+
+typedef struct
+{
+	SDL_Renderer *renderer;
+	struct vec2i mapSize;
+	struct vec2i size; // in chunks
+	CArray chunks;	   // of FloorChunk
+	bool isSupported;
+	int numTextures;
+	uint64_t drawCount;
+} FloorChunks;
+static FloorChunks sFloorChunks;
+
+void FloorChunksInvalidate(void)
+{
+	FloorChunks *fc = &sFloorChunks;
+	if (fc->chunks.elemSize == 0)
+	{
+		return;
+	}
+	CA_FOREACH(FloorChunk, c, fc->chunks)
+	if (c->tex != NULL)
+	{
+		SDL_DestroyTexture(c->tex);
+	}
+	CA_FOREACH_END()
+	CArrayTerminate(&fc->chunks);
+	memset(fc, 0, sizeof *fc);
+}
+
+static bool IsFloorTile(const Tile *t)
+{
+	return t->Class != NULL && t->Class->Pic != NULL &&
+		   t->Class->Pic->Data != NULL && t->Class->Type != TILE_CLASS_WALL;
+}
+
+static bool FloorChunksInit(SDL_Renderer *renderer)
+{
+	FloorChunks *fc = &sFloorChunks;
+	if (fc->renderer == renderer && svec2i_is_equal(fc->mapSize, gMap.Size))
+	{
+		return fc->isSupported;
+	}
+	FloorChunksInvalidate();
+	fc->renderer = renderer;
+	fc->mapSize = gMap.Size;
+	SDL_RendererInfo ri;
+	fc->isSupported = SDL_GetRendererInfo(renderer, &ri) == 0 &&
+					  (ri.flags & SDL_RENDERER_TARGETTEXTURE);
+	if (!fc->isSupported)
+	{
+		LOG(LM_GFX, LL_WARN,
+			"renderer does not support render to texture; "
+			"drawing floor per tile");
+		return false;
+	}
+	fc->size = svec2i(
+		(gMap.Size.x + FLOOR_CHUNK_SIZE - 1) / FLOOR_CHUNK_SIZE,
+		(gMap.Size.y + FLOOR_CHUNK_SIZE - 1) / FLOOR_CHUNK_SIZE);
+	CArrayInitFillZero(
+		&fc->chunks, sizeof(FloorChunk), fc->size.x * fc->size.y);
+	return true;
+}
+
+// Check if any of the chunk's tiles have changed since it was drawn
+static void FloorChunkCheckDirty(FloorChunk *c, const struct vec2i chunkPos)
+{
+	if (c->tex == NULL)
+	{
+		c->isDirty = true;
+		return;
+	}
+	const struct vec2i start = svec2i_scale(chunkPos, FLOOR_CHUNK_SIZE);
+	struct vec2i v;
+	for (v.y = 0; v.y < FLOOR_CHUNK_SIZE; v.y++)
+	{
+		for (v.x = 0; v.x < FLOOR_CHUNK_SIZE; v.x++)
+		{
+			const struct vec2i tilePos = svec2i_add(start, v);
+			if (!MapIsTileIn(&gMap, tilePos))
+			{
+				continue;
+			}
+			const Tile *t = MapGetTile(&gMap, tilePos);
+			if (c->classes[v.y * FLOOR_CHUNK_SIZE + v.x] != t->Class)
+			{
+				c->isDirty = true;
+				return;
+			}
+		}
+	}
+}
+
+static void FloorChunksEvictLRU(FloorChunks *fc);
+static bool FloorChunkRedraw(
+	FloorChunks *fc, FloorChunk *c, const struct vec2i chunkPos)
+{
+	if (c->tex == NULL)
+	{
+		if (fc->numTextures >= FLOOR_CHUNK_TEXTURES_MAX)
+		{
+			FloorChunksEvictLRU(fc);
+		}
+		c->tex = TextureCreate(
+			fc->renderer, SDL_TEXTUREACCESS_TARGET,
+			svec2i(
+				FLOOR_CHUNK_SIZE * TILE_WIDTH, FLOOR_CHUNK_SIZE * TILE_HEIGHT),
+			SDL_BLENDMODE_BLEND, 255);
+		if (c->tex == NULL)
+		{
+			return false;
+		}
+		fc->numTextures++;
+	}
+	if (SDL_SetRenderTarget(fc->renderer, c->tex) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot set render target: %s", SDL_GetError());
+		return false;
+	}
+	SDL_SetRenderDrawColor(fc->renderer, 0, 0, 0, 0);
+	SDL_RenderClear(fc->renderer);
+	const struct vec2i start = svec2i_scale(chunkPos, FLOOR_CHUNK_SIZE);
+	struct vec2i v;
+	for (v.y = 0; v.y < FLOOR_CHUNK_SIZE; v.y++)
+	{
+		for (v.x = 0; v.x < FLOOR_CHUNK_SIZE; v.x++)
+		{
+			const struct vec2i tilePos = svec2i_add(start, v);
+			const Tile *t = MapIsTileIn(&gMap, tilePos)
+								? MapGetTile(&gMap, tilePos)
+								: NULL;
+			c->classes[v.y * FLOOR_CHUNK_SIZE + v.x] =
+				t != NULL ? t->Class : NULL;
+			if (t == NULL || !IsFloorTile(t))
+			{
+				continue;
+			}
+			// Copy the pixels as is; blending onto the transparent chunk
+			// would multiply by alpha again when the chunk is drawn
+			SDL_Texture *tex = t->Class->Pic->Tex;
+			SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+			SDL_GetTextureBlendMode(tex, &mode);
+			SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_NONE);
+			PicRender(
+				t->Class->Pic, fc->renderer,
+				svec2i(v.x * TILE_WIDTH, v.y * TILE_HEIGHT), colorWhite, 0,
+				svec2_one(), SDL_FLIP_NONE, Rect2iZero());
+			SDL_SetTextureBlendMode(tex, mode);
+		}
+	}
+	c->isDirty = false;
+	return true;
+}
+static void FloorChunksEvictLRU(FloorChunks *fc)
+{
+	// Chunks drawn in this call are never evicted
+	FloorChunk *lru = NULL;
+	CA_FOREACH(FloorChunk, c, fc->chunks)
+	if (c->tex != NULL && c->lastUsed != fc->drawCount &&
+		(lru == NULL || c->lastUsed < lru->lastUsed))
+	{
+		lru = c;
+	}
+	CA_FOREACH_END()
+	if (lru == NULL)
+	{
+		return;
+	}
+	SDL_DestroyTexture(lru->tex);
+	lru->tex = NULL;
+	lru->isDirty = true;
+	fc->numTextures--;
+}
+
+// Get the mask to draw a floor tile with, as for per tile drawing:
+// unvisited tiles, or out of sight tiles if fog is disabled, aren't drawn
+static bool GetTileLOSMask(
+	const Tile *t, const bool useFog, color_t *mask)
+{
+	if (!t->isVisited || (t->outOfSight && !useFog))
+	{
+		return false;
+	}
+	*mask = t->outOfSight ? colorFog : colorWhite;
+	return true;
+}
+
+static void DrawChunkRow(
+	SDL_Renderer *renderer, const FloorChunk *c, const struct vec2i chunkTile,
+	const struct vec2i origin, const int y, const int xStart, const int xEnd,
+	const bool useFog)
+{
+	// Draw runs of tiles that share the same mask with one copy each
+	int spanStart = -1;
+	color_t spanMask = colorWhite;
+	for (int x = xStart; x <= xEnd; x++)
+	{
+		color_t mask = colorWhite;
+		bool draw = false;
+		if (x < xEnd)
+		{
+			const Tile *t = MapGetTile(&gMap, svec2i(x, y));
+			if (!IsFloorTile(t))
+			{
+				// Transparent in the chunk; join any span
+				if (spanStart >= 0)
+				{
+					continue;
+				}
+			}
+			else
+			{
+				draw = GetTileLOSMask(t, useFog, &mask);
+			}
+		}
+		if (spanStart >= 0 && (!draw || !ColorEquals(mask, spanMask)))
+		{
+			const struct vec2i size =
+				svec2i((x - spanStart) * TILE_WIDTH, TILE_HEIGHT);
+			const Rect2i src = Rect2iNew(
+				svec2i(
+					(spanStart - chunkTile.x) * TILE_WIDTH,
+					(y - chunkTile.y) * TILE_HEIGHT),
+				size);
+			const Rect2i dest = Rect2iNew(
+				svec2i_add(
+					origin,
+					svec2i(spanStart * TILE_WIDTH, y * TILE_HEIGHT)),
+				size);
+			TextureRender(
+				c->tex, renderer, src, dest, spanMask, 0, SDL_FLIP_NONE);
+			spanStart = -1;
+		}
+		if (draw && spanStart < 0)
+		{
+			spanStart = x;
+			spanMask = mask;
+		}
+	}
+}
+
+bool FloorChunksDraw(
+	const DrawBuffer *b, const struct vec2i offset, const bool useFog)
+{
+	SDL_Renderer *renderer = gGraphicsDevice.gameWindow.renderer;
+	if (!FloorChunksInit(renderer))
+	{
+		return false;
+	}
+	FloorChunks *fc = &sFloorChunks;
+	fc->drawCount++;
+
+	// Visible tile window, clamped to the map
+	const struct vec2i tileStart =
+		svec2i(MAX(b->xStart, 0), MAX(b->yStart, 0));
+	const struct vec2i tileEnd = svec2i(
+		MIN(b->xStart + b->Size.x, gMap.Size.x),
+		MIN(b->yStart + Y_TILES, gMap.Size.y));
+	if (tileStart.x >= tileEnd.x || tileStart.y >= tileEnd.y)
+	{
+		return true;
+	}
+
+	// Redraw dirty chunks, preserving the current render target
+	SDL_Texture *target = SDL_GetRenderTarget(renderer);
+	SDL_Rect clip;
+	SDL_RenderGetClipRect(renderer, &clip);
+	bool changedTarget = false;
+	const struct vec2i chunkStart =
+		svec2i_scale_divide(tileStart, FLOOR_CHUNK_SIZE);
+	const struct vec2i chunkEnd = svec2i(
+		(tileEnd.x - 1) / FLOOR_CHUNK_SIZE,
+		(tileEnd.y - 1) / FLOOR_CHUNK_SIZE);
+	struct vec2i cv;
+	for (cv.y = chunkStart.y; cv.y <= chunkEnd.y; cv.y++)
+	{
+		for (cv.x = chunkStart.x; cv.x <= chunkEnd.x; cv.x++)
+		{
+			FloorChunk *c = CArrayGet(&fc->chunks, cv.y * fc->size.x + cv.x);
+			c->lastUsed = fc->drawCount;
+			FloorChunkCheckDirty(c, cv);
+			if (!c->isDirty)
+			{
+				continue;
+			}
+			changedTarget = true;
+			if (!FloorChunkRedraw(fc, c, cv))
+			{
+				SDL_SetRenderTarget(renderer, target);
+				FloorChunksInvalidate();
+				return false;
+			}
+		}
+	}
+	if (changedTarget)
+	{
+		SDL_SetRenderTarget(renderer, target);
+		SDL_RenderSetClipRect(renderer, SDL_RectEmpty(&clip) ? NULL : &clip);
+	}
+
+	// Draw the visible part of each chunk, row by row, so that line of sight
+	// is applied as it is for per tile drawing
+	const struct vec2i origin = svec2i(
+		b->dx + offset.x - (b->xStart * TILE_WIDTH),
+		b->dy + offset.y - (b->yStart * TILE_HEIGHT));
+	for (cv.y = chunkStart.y; cv.y <= chunkEnd.y; cv.y++)
+	{
+		for (cv.x = chunkStart.x; cv.x <= chunkEnd.x; cv.x++)
+		{
+			const FloorChunk *c =
+				CArrayGet(&fc->chunks, cv.y * fc->size.x + cv.x);
+			const struct vec2i chunkTile =
+				svec2i_scale(cv, FLOOR_CHUNK_SIZE);
+			const struct vec2i start = svec2i(
+				MAX(chunkTile.x, tileStart.x), MAX(chunkTile.y, tileStart.y));
+			const struct vec2i end = svec2i(
+				MIN(chunkTile.x + FLOOR_CHUNK_SIZE, tileEnd.x),
+				MIN(chunkTile.y + FLOOR_CHUNK_SIZE, tileEnd.y));
+			for (int y = start.y; y < end.y; y++)
+			{
+				DrawChunkRow(
+					renderer, c, chunkTile, origin, y, start.x, end.x, useFog);
+			}
+		}
+	}
+	return true;
+}
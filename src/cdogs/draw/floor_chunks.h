@@ -0,0 +1,41 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "draw/draw_buffer.h"
+
+// Floor tiles don't change often, so they are pre-rendered into textures of
+// FLOOR_CHUNK_SIZE x FLOOR_CHUNK_SIZE tiles, and drawn a chunk at a time.
+// Line of sight is applied when drawing from the chunks, by tinting or
+// skipping runs of tiles.
+#define FLOOR_CHUNK_SIZE 16
+
+// Drop all chunks; call when the map or renderer changes
+void FloorChunksInvalidate(void);
+// Draw the floor tiles of the buffer; returns false if chunks are not
+// supported, and the floor should be drawn per tile instead
+bool FloorChunksDraw(
+	const DrawBuffer *b, const struct vec2i offset, const bool useFog);
@@ -85,8 +85,8 @@ void Draw9Slice(
 						src.Size.y = dst.Size.y = dstY[j + 1] - dst.Pos.y;
 					}
 					TextureRender(
-						pic->Tex, g->gameWindow.renderer, src, dst, mask, 0,
-						flip);
+						pic->Tex, g->gameWindow.renderer,
+						PicGetTexRect(pic, src), dst, mask, 0, flip);
 				}
 			}
 		}
@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include "blit.h"
+#include "c_hashmap/hashmap.h"
 #include "log.h"
 #include "pic.h"
 #include "sys_config.h"
@@ -37,8 +38,36 @@
 #define FIRST_CHAR 0
 #define LAST_CHAR 255
 
+// Limits for the text run cache
+#define TEXT_RUN_MAX 512
+#define TEXT_RUN_LEN_MAX 1024
+#define TEXT_RUN_UNUSED_FRAMES 60
+
 Font gFont;
 
+// Wrapped text that is drawn repeatedly, like menu descriptions, is cached
+// with its line splitting and glyph layout already done, keyed by the text.
+// The glyphs are still drawn from the font atlas, so overlapping glyphs blend
+// as usual and consecutive draws batch. Unwrapped text is cheap enough to lay
+// out on the fly, so it isn't cached.
+typedef struct
+{
+	const Pic *pic;
+	struct vec2i pos;	// relative to start
+} TextRunGlyph;
+typedef struct
+{
+	char *key;
+	int width;
+	CArray glyphs;	// of TextRunGlyph
+	struct vec2i end;	// cursor position after drawing, relative to start
+	int lastUsed;
+} TextRun;
+static map_t sTextRuns = NULL;
+static int sTextRunFrame = 0;
+static void TextRunsClear(void);
+static void TextRunDestroy(any_t data);
+
 FontOpts FontOptsNew(void)
 {
 	FontOpts opts;
@@ -67,6 +96,8 @@ void FontLoad(
 	}
 
 	CArrayInit(&f->Chars, sizeof(Pic));
+	// Cached text was laid out with the old font
+	TextRunsClear();
 
 	// Check that the image is big enough for the dimensions
 	const struct vec2i step = svec2i(
@@ -112,6 +143,16 @@ void FontLoad(
 		}
 	}
 	SDL_UnlockSurface(image);
+
+	// Pack all the glyphs into one texture so text draws are batched
+	TextureAtlasInit(&f->atlas);
+	CArray pics;
+	CArrayInit(&pics, sizeof(Pic *));
+	CA_FOREACH(Pic, p, f->Chars)
+	CArrayPushBack(&pics, &p);
+	CA_FOREACH_END()
+	TextureAtlasAddPics(&f->atlas, &pics);
+	CArrayTerminate(&pics);
 }
 void FontTerminate(Font *f)
 {
@@ -119,6 +160,10 @@ void FontTerminate(Font *f)
 	PicFree(p);
 	CA_FOREACH_END()
 	CArrayTerminate(&f->Chars);
+	TextureAtlasTerminate(&f->atlas);
+	TextRunsClear();
+	hashmap_free(sTextRuns);
+	sTextRuns = NULL;
 }
 
 int FontW(const char c)
@@ -204,8 +249,7 @@ struct vec2i FontCh(const char c, const struct vec2i pos)
 {
 	return FontChMask(c, pos, colorWhite);
 }
-struct vec2i FontChMask(
-	const char c, const struct vec2i pos, const color_t mask)
+static const Pic *GetChPic(const char c)
 {
 	int idx = (int)c - FIRST_CHAR;
 	if (idx < 0)
@@ -217,7 +261,12 @@ struct vec2i FontChMask(
 		fprintf(stderr, "invalid char %d\n", idx);
 		idx = FIRST_CHAR;
 	}
-	const Pic *pic = CArrayGet(&gFont.Chars, idx);
+	return CArrayGet(&gFont.Chars, idx);
+}
+struct vec2i FontChMask(
+	const char c, const struct vec2i pos, const color_t mask)
+{
+	const Pic *pic = GetChPic(c);
 	PicRender(
 		pic, gGraphicsDevice.gameWindow.renderer, pos, mask, 0, svec2_one(),
 		SDL_FLIP_NONE, Rect2iZero());
@@ -228,12 +277,12 @@ struct vec2i FontStr(const char *s, struct vec2i pos)
 {
 	return FontStrMask(s, pos, colorWhite);
 }
-struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask)
+static struct vec2i DrawTextRun(
+	const char *s, const struct vec2i pos, const color_t mask,
+	const int width);
+static struct vec2i DrawStrMask(
+	const char *s, struct vec2i pos, const color_t mask)
 {
-	if (s == NULL)
-	{
-		return pos;
-	}
 	int left = pos.x;
 	while (*s)
 	{
@@ -250,14 +299,151 @@ struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask)
 	}
 	return pos;
 }
+struct vec2i FontStrMask(const char *s, struct vec2i pos, const color_t mask)
+{
+	if (s == NULL)
+	{
+		return pos;
+	}
+	return DrawTextRun(s, pos, mask, 0);
+}
 struct vec2i FontStrMaskWrap(
 	const char *s, struct vec2i pos, color_t mask, const int width)
 {
-	char buf[1024];
 	CASSERT(strlen(s) < 1024, "string too long to wrap");
-	FontSplitLines(s, buf, width);
-	return FontStrMask(buf, pos, mask);
+	return DrawTextRun(s, pos, mask, width);
+}
+
+static TextRun *GetTextRun(const char *s, const int width);
+static struct vec2i DrawTextRun(
+	const char *s, const struct vec2i pos, const color_t mask,
+	const int width)
+{
+	if (width == 0)
+	{
+		return DrawStrMask(s, pos, mask);
+	}
+	const TextRun *r = GetTextRun(s, width);
+	if (r == NULL)
+	{
+		// Not cacheable; draw character by character
+		char buf[1024];
+		FontSplitLines(s, buf, width);
+		return DrawStrMask(buf, pos, mask);
+	}
+	CA_FOREACH(const TextRunGlyph, g, r->glyphs)
+	PicRender(
+		g->pic, gGraphicsDevice.gameWindow.renderer, svec2i_add(pos, g->pos),
+		mask, 0, svec2_one(), SDL_FLIP_NONE, Rect2iZero());
+	CA_FOREACH_END()
+	return svec2i_add(pos, r->end);
+}
+static void TextRunLayout(TextRun *r, const int width);
+static TextRun *GetTextRun(const char *s, const int width)
+{
+	if (gFont.Chars.size == 0 || strlen(s) >= TEXT_RUN_LEN_MAX)
+	{
+		return NULL;
+	}
+	if (sTextRuns == NULL)
+	{
+		sTextRuns = hashmap_new();
+	}
+	// Key is the text; the mask is applied when drawing
+	TextRun *r;
+	if (hashmap_get(sTextRuns, s, (any_t *)&r) == MAP_OK)
+	{
+		if (r->width != width)
+		{
+			// Same text wrapped differently; lay it out again
+			CArrayTerminate(&r->glyphs);
+			TextRunLayout(r, width);
+		}
+		r->lastUsed = sTextRunFrame;
+		return r;
+	}
+	if (hashmap_length(sTextRuns) >= TEXT_RUN_MAX)
+	{
+		return NULL;
+	}
+	CCALLOC(r, sizeof *r);
+	CSTRDUP(r->key, s);
+	TextRunLayout(r, width);
+	r->lastUsed = sTextRunFrame;
+	if (hashmap_put(sTextRuns, r->key, r) != MAP_OK)
+	{
+		LOG(LM_GFX, LL_ERROR, "failed to add text run %s", r->key);
+		TextRunDestroy(r);
+		return NULL;
+	}
+	return r;
+}
+static void TextRunLayout(TextRun *r, const int width)
+{
+	// Lay out the glyphs exactly as DrawStrMask would
+	char text[1024];
+	FontSplitLines(r->key, text, width);
+	r->width = width;
+	CArrayInit(&r->glyphs, sizeof(TextRunGlyph));
+	struct vec2i pos = svec2i_zero();
+	for (const char *c = text; *c; c++)
+	{
+		if (*c == '\n')
+		{
+			pos.x = 0;
+			pos.y += FontH();
+			continue;
+		}
+		const TextRunGlyph g = {GetChPic(*c), pos};
+		CArrayPushBack(&r->glyphs, &g);
+		pos.x += g.pic->size.x + gFont.Gap.x;
+	}
+	r->end = pos;
 }
+static void TextRunDestroy(any_t data)
+{
+	TextRun *r = data;
+	CArrayTerminate(&r->glyphs);
+	CFREE(r->key);
+	CFREE(r);
+}
+static void TextRunsClear(void)
+{
+	if (sTextRuns != NULL)
+	{
+		hashmap_clear(sTextRuns, TextRunDestroy);
+	}
+}
+static int KeepUsedTextRun(any_t data, any_t item);
+void FontUpdateTextRuns(void)
+{
+	sTextRunFrame++;
+	// Only evict periodically, since it rebuilds the whole map
+	if (sTextRuns == NULL || sTextRunFrame % TEXT_RUN_UNUSED_FRAMES != 0)
+	{
+		return;
+	}
+	// Rebuild the map with only the recently used runs
+	map_t kept = hashmap_new();
+	hashmap_iterate(sTextRuns, KeepUsedTextRun, kept);
+	hashmap_free(sTextRuns);
+	sTextRuns = kept;
+}
+static int KeepUsedTextRun(any_t data, any_t item)
+{
+	map_t kept = data;
+	TextRun *r = item;
+	if (sTextRunFrame - r->lastUsed > TEXT_RUN_UNUSED_FRAMES)
+	{
+		TextRunDestroy(r);
+	}
+	else
+	{
+		hashmap_put(kept, r->key, r);
+	}
+	return MAP_OK;
+}
+
 static struct vec2i GetStrPos(
 	const char *s, struct vec2i pos, const FontOpts opts);
 void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts)
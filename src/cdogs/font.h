@@ -28,6 +28,7 @@
 #include <SDL_surface.h>
 
 #include "c_array.h"
+#include "texture_atlas.h"
 #include "vector.h"
 
 #define ARROW_LEFT "\x11"
@@ -50,6 +51,7 @@ typedef struct
 	} Padding;
 	struct vec2i Gap;
 	CArray Chars; // of Pic
+	TextureAtlas atlas;
 } Font;
 
 typedef enum
@@ -95,6 +97,9 @@ struct vec2i FontStrMaskWrap(
 	const char *s, struct vec2i pos, color_t mask, const int width);
 void FontStrOpt(const char *s, struct vec2i pos, const FontOpts opts);
 void FontStrCenter(const char *s);
+// Advance the text run cache by a frame, evicting text not drawn recently
+// Call this once per frame
+void FontUpdateTextRuns(void);
 
 void FontSplitLines(const char *text, char *buf, const int width);
 
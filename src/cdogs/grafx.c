@@ -60,6 +60,7 @@
 #include "config.h"
 #include "defs.h"
 #include "draw/drawtools.h"
+#include "draw/floor_chunks.h"
 #include "files.h"
 #include "font_utils.h"
 #include "grafx_bg.h"
@@ -124,6 +125,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 			windowDim.Pos = svec2i_zero();
 		}
 		LOG(LM_GFX, LL_DEBUG, "destroying previous renderer");
+		FloorChunksInvalidate();
 		WindowContextDestroy(&g->gameWindow);
 		WindowContextDestroy(&g->secondWindow);
 		SDL_FreeFormat(g->Format);
@@ -287,6 +289,7 @@ void GraphicsInitialize(GraphicsDevice *g)
 
 void GraphicsTerminate(GraphicsDevice *g)
 {
+	FloorChunksInvalidate();
 	WindowContextDestroy(&g->gameWindow);
 	WindowContextDestroy(&g->secondWindow);
 	SDL_FreeFormat(g->Format);
@@ -42,6 +42,17 @@
 #include "thing.h"
 #include "triggers.h"
 
+// Config and sounds read in hot paths
+static ConfigHandle sFootstepsConfig = CONFIG_HANDLE("Sound.Footsteps");
+static SoundHandle sSpawnSound = SOUND_HANDLE("spawn");
+static SoundHandle sSlideSound = SOUND_HANDLE("slide");
+static SoundHandle sAmmoNoneSound = SOUND_HANDLE("ammo_none");
+static SoundHandle sAmmoLowSound = SOUND_HANDLE("ammo_low");
+static SoundHandle sSpawnItemSound = SOUND_HANDLE("spawn_item");
+static SoundHandle sRescueSound = SOUND_HANDLE("rescue");
+static SoundHandle sMissionCompleteSound = SOUND_HANDLE("mission_complete");
+static SoundHandle sWhistleSound = SOUND_HANDLE("whistle");
+
 #define RELOAD_DISTANCE_PLUS 200
 
 static void HandleGameEvent(
@@ -95,6 +106,7 @@ static void HandleGameEvent(
 			t->Door.Class = doorClass;
 			t->Door.Class2 = doorClass2;
 			DoorStateInit(&t->Door, false);
+			MapUpdateSpawnTile(&gMap, pos);
 			pos.x++;
 			if (pos.x == gMap.Size.x)
 			{
@@ -158,7 +170,7 @@ static void HandleGameEvent(
 		break;
 	case GAME_EVENT_SOUND_AT:
 		SoundPlayAtPlusDistance(
-			sd, StrSound(e.u.SoundAt.Sound), NetToVec2(e.u.SoundAt.Pos),
+			sd, SoundIdGet(e.u.SoundAt.Sound), NetToVec2(e.u.SoundAt.Pos),
 			e.u.SoundAt.Distance);
 		break;
 	case GAME_EVENT_SCREEN_SHAKE:
@@ -192,7 +204,7 @@ static void HandleGameEvent(
 		// Spawn sound for player actors
 		if (e.u.ActorAdd.PlayerUID >= 0)
 		{
-			SoundPlayAt(sd, StrSound("spawn"), a->Pos);
+			SoundPlayAt(sd, SoundHandleGet(&sSpawnSound), a->Pos);
 		}
 	}
 	break;
@@ -220,9 +232,9 @@ static void HandleGameEvent(
 			break;
 		a->thing.Vel = NetToVec2(e.u.ActorSlide.Vel);
 		// Slide sound
-		if (ConfigGetBool(&gConfig, "Sound.Footsteps"))
+		if (ConfigHandleBool(&sFootstepsConfig))
 		{
-			SoundPlayAt(sd, StrSound("slide"), a->thing.Pos);
+			SoundPlayAt(sd, SoundHandleGet(&sSlideSound), a->thing.Pos);
 		}
 	}
 	break;
@@ -324,12 +336,12 @@ static void HandleGameEvent(
 			if (ammoAfter == 0)
 			{
 				// No ammo
-				SoundPlay(sd, StrSound("ammo_none"));
+				SoundPlay(sd, SoundHandleGet(&sAmmoNoneSound));
 			}
 			else if (!wasAmmoLow && isAmmoLow)
 			{
 				// Low ammo
-				SoundPlay(sd, StrSound("ammo_low"));
+				SoundPlay(sd, SoundHandleGet(&sAmmoLowSound));
 			}
 		}
 	}
@@ -388,7 +400,7 @@ static void HandleGameEvent(
 	case GAME_EVENT_ADD_PICKUP:
 		PickupAdd(e.u.AddPickup);
 		// Play a spawn sound
-		SoundPlayAt(sd, StrSound("spawn_item"), NetToVec2(e.u.AddPickup.Pos));
+		SoundPlayAt(sd, SoundHandleGet(&sSpawnItemSound), NetToVec2(e.u.AddPickup.Pos));
 		break;
 	case GAME_EVENT_REMOVE_PICKUP:
 		PickupDestroy(e.u.RemovePickup.UID);
@@ -396,6 +408,7 @@ static void HandleGameEvent(
 		{
 			TObject *o = ObjGetByUID(e.u.RemovePickup.SpawnerUID);
 			o->counter = AMMO_SPAWNER_RESPAWN_TICKS;
+			ObjWake(o);
 		}
 		break;
 	case GAME_EVENT_BULLET_BOUNCE:
@@ -481,7 +494,7 @@ static void HandleGameEvent(
 		{
 			a->flags |= FLAGS_RESCUED;
 		}
-		SoundPlayAt(sd, StrSound("rescue"), a->Pos);
+		SoundPlayAt(sd, SoundHandleGet(&sRescueSound), a->Pos);
 	}
 	break;
 	case GAME_EVENT_OBJECTIVE_UPDATE: {
@@ -530,7 +543,7 @@ static void HandleGameEvent(
 		{
 			if (!gMission.MissionCompleted)
 			{
-				SoundPlay(sd, StrSound("mission_complete"));
+				SoundPlay(sd, SoundHandleGet(&sMissionCompleteSound));
 			}
 			if (camera != NULL)
 			{
@@ -557,7 +570,7 @@ static void HandleGameEvent(
 	case GAME_EVENT_MISSION_PICKUP:
 		gMission.state = MISSION_STATE_PICKUP;
 		gMission.pickupTime = gMission.time;
-		SoundPlay(sd, StrSound("whistle"));
+		SoundPlay(sd, SoundHandleGet(&sWhistleSound));
 		break;
 	case GAME_EVENT_MISSION_END:
 		MissionDone(&gMission, e.u.MissionEnd);
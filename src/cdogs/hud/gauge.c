@@ -36,30 +36,32 @@
 // (XXXXXXXX|     )
 //  --------------
 void HUDDrawGauge(
-	GraphicsDevice *g, const PicManager *pm, struct vec2i pos,
+	GraphicsDevice *g, struct vec2i pos,
 	const int width, const int innerWidth,
 	const color_t barColor, const color_t backColor)
 {
 	const int height = 10; // TODO: arbitrary height
 
-	const Pic *backPic = PicManagerGetPic(pm, "hud/gauge_back");
+	static PicHandle backPicHandle = PIC_HANDLE("hud/gauge_back");
+	const Pic *backPic = PicHandleGet(&backPicHandle);
 	Draw9Slice(
 		g, backPic, Rect2iNew(pos, svec2i(width, height)), 0, 3, 0, 4, false,
 		backColor, SDL_FLIP_NONE);
 
 	if (innerWidth > 0)
 	{
-		HUDDrawGaugeInner(g, pm, pos, innerWidth, barColor);
+		HUDDrawGaugeInner(g, pos, innerWidth, barColor);
 	}
 }
 
 void HUDDrawGaugeInner(
-	GraphicsDevice *g, const PicManager *pm, struct vec2i pos,
+	GraphicsDevice *g, struct vec2i pos,
 	const int width, const color_t barColor)
 {
 	const int height = 10; // TODO: arbitrary height
 
-	const Pic *innerPic = PicManagerGetPic(pm, "hud/gauge_inner");
+	static PicHandle innerPicHandle = PIC_HANDLE("hud/gauge_inner");
+	const Pic *innerPic = PicHandleGet(&innerPicHandle);
 	Draw9Slice(
 		g, innerPic, Rect2iNew(pos, svec2i(width, height)), 0, 3, 0, 4, false,
 		barColor, SDL_FLIP_NONE);
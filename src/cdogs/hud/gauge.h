@@ -33,9 +33,9 @@
 
 
 void HUDDrawGauge(
-	GraphicsDevice *g, const PicManager *pm, struct vec2i pos,
+	GraphicsDevice *g, struct vec2i pos,
 	const int width, const int innerWidth,
 	const color_t barColor, const color_t backColor);
 void HUDDrawGaugeInner(
-	GraphicsDevice *g, const PicManager *pm, struct vec2i pos,
+	GraphicsDevice *g, struct vec2i pos,
 	const int width, const color_t barColor);
@@ -71,7 +71,7 @@ void HealthGaugeDraw(
 	const color_t mask)
 {
 	// Draw gauge background
-	HUDDrawGauge(device, &gPicManager, pos, width, 0, colorTransparent, mask);
+	HUDDrawGauge(device, pos, width, 0, colorTransparent, mask);
 	if (actor == NULL)
 	{
 		return;
@@ -106,14 +106,13 @@ void HealthGaugeDraw(
 		const int innerWidthUpdate = MAX(1, width * higherHealth / maxHealth);
 		barColor = h->health > health ? colorMaroon : colorGreen;
 		barColor.a = opts.Mask.a;
-		HUDDrawGaugeInner(
-			device, &gPicManager, pos, innerWidthUpdate, barColor);
+		HUDDrawGaugeInner(device, pos, innerWidthUpdate, barColor);
 	}
 	const int lowerHealth = MIN(h->health, health);
 	const int innerWidth = MAX(1, width * lowerHealth / maxHealth);
 	barColor = ColorTint(colorWhite, hsv);
 	barColor.a = opts.Mask.a;
-	HUDDrawGaugeInner(device, &gPicManager, pos, innerWidth, barColor);
+	HUDDrawGaugeInner(device, pos, innerWidth, barColor);
 
 	// Draw a second bar if health is over max
 	if (actor->health > maxHealth)
@@ -128,7 +127,7 @@ void HealthGaugeDraw(
 		hsv.v = 1.0;
 		barColor = ColorTint(colorWhite, hsv);
 		barColor.a = opts.Mask.a;
-		HUDDrawGaugeInner(device, &gPicManager, pos, innerWidth2, barColor);
+		HUDDrawGaugeInner(device, pos, innerWidth2, barColor);
 	}
 
 	// Draw health number label
@@ -126,17 +126,17 @@ void DrawPlayerHUD(
 }
 
 static void DrawPlayerIcon(
-	const TActor *a, GraphicsDevice *g, const PicManager *pm, const int flags,
+	const TActor *a, GraphicsDevice *g, const int flags,
 	const SDL_RendererFlip flip, const color_t mask);
 static void DrawScore(
-	GraphicsDevice *g, const PicManager *pm, const TActor *a, const int score,
-	const int flags, const Rect2i r, const color_t mask);
+	GraphicsDevice *g, const TActor *a, const int score, const int flags,
+	const Rect2i r, const color_t mask);
 static void DrawLives(
 	const GraphicsDevice *device, const PlayerData *player,
 	const FontAlign hAlign, const FontAlign vAlign);
 static void DrawWeaponStatus(
-	GraphicsDevice *g, const PicManager *pm, const TActor *actor,
-	const int flags, const Rect2i r, const color_t mask);
+	GraphicsDevice *g, const TActor *actor, const int flags, const Rect2i r,
+	const color_t mask);
 static void DrawGunIcons(
 	GraphicsDevice *g, const TActor *actor, const int flags,
 	const HUDPlayer *h, const Rect2i r);
@@ -165,10 +165,11 @@ static void DrawPlayerStatus(
 		flip |= SDL_FLIP_VERTICAL;
 	}
 
-	DrawPlayerIcon(p, hud->device, &gPicManager, flags, flip, mask);
+	DrawPlayerIcon(p, hud->device, flags, flip, mask);
 
 	// Draw back bar, stretched across the screen
-	const Pic *backBar = PicManagerGetPic(&gPicManager, "hud/back_bar");
+	static PicHandle backBarPic = PIC_HANDLE("hud/back_bar");
+	const Pic *backBar = PicHandleGet(&backBarPic);
 	const int barWidth = r.Size.x - 22;
 	struct vec2i barPos = svec2i(22, 0);
 	if (flags & HUDFLAGS_PLACE_RIGHT)
@@ -194,9 +195,9 @@ static void DrawPlayerStatus(
 	}
 	opts.Area = gGraphicsDevice.cachedConfig.Res;
 
-	DrawScore(hud->device, &gPicManager, p, data->Stats.Score, flags, r, mask);
+	DrawScore(hud->device, p, data->Stats.Score, flags, r, mask);
 	DrawGrenadeStatus(hud->device, p, flags, h, r);
-	DrawWeaponStatus(hud->device, &gPicManager, p, flags, r, mask);
+	DrawWeaponStatus(hud->device, p, flags, r, mask);
 	DrawGunIcons(hud->device, p, flags, h, r);
 	DrawLives(hud->device, data, opts.HAlign, opts.VAlign);
 	DrawHealth(hud->device, p, flags, h, r, mask);
@@ -227,11 +228,14 @@ static void DrawPlayerStatus(
 	}
 }
 static void DrawPlayerIcon(
-	const TActor *a, GraphicsDevice *g, const PicManager *pm, const int flags,
+	const TActor *a, GraphicsDevice *g, const int flags,
 	const SDL_RendererFlip flip, const color_t mask)
 {
-	const Pic *framePic = PicManagerGetPic(pm, "hud/player_frame");
-	const Pic *underlayPic = PicManagerGetPic(pm, "hud/player_frame_underlay");
+	static PicHandle framePicHandle = PIC_HANDLE("hud/player_frame");
+	static PicHandle underlayPicHandle =
+		PIC_HANDLE("hud/player_frame_underlay");
+	const Pic *framePic = PicHandleGet(&framePicHandle);
+	const Pic *underlayPic = PicHandleGet(&underlayPicHandle);
 	struct vec2i picPos = svec2i_zero();
 	if (flags & HUDFLAGS_PLACE_RIGHT)
 	{
@@ -268,8 +272,8 @@ static void DrawPlayerIcon(
 		Rect2iZero());
 }
 static void DrawScore(
-	GraphicsDevice *g, const PicManager *pm, const TActor *a, const int score,
-	const int flags, const Rect2i r, const color_t mask)
+	GraphicsDevice *g, const TActor *a, const int score, const int flags,
+	const Rect2i r, const color_t mask)
 {
 	// Score aligned to the right
 	struct vec2i backPos = svec2i(r.Size.x - SCORE_WIDTH, 1);
@@ -282,7 +286,7 @@ static void DrawScore(
 		backPos.y = g->cachedConfig.Res.y - BAR_HEIGHT + backPos.y;
 	}
 
-	HUDDrawGauge(g, pm, backPos, SCORE_WIDTH, 0, colorTransparent, mask);
+	HUDDrawGauge(g, backPos, SCORE_WIDTH, 0, colorTransparent, mask);
 
 	if (a == NULL)
 	{
@@ -338,11 +342,14 @@ static void DrawLives(
 }
 
 static void DrawWeaponStatus(
-	GraphicsDevice *g, const PicManager *pm, const TActor *actor,
-	const int flags, const Rect2i r, const color_t mask)
+	GraphicsDevice *g, const TActor *actor, const int flags, const Rect2i r,
+	const color_t mask)
 {
 	// TODO: draw as gauge
-	const Pic *backPic = PicManagerGetPic(pm, "hud/gauge_small_back");
+	static PicHandle backPicHandle = PIC_HANDLE("hud/gauge_small_back");
+	static PicHandle fillPicHandle = PIC_HANDLE("hud/gauge_small_inner");
+	static PicHandle ballPicHandle = PIC_HANDLE("hud/gauge_small_ball");
+	const Pic *backPic = PicHandleGet(&backPicHandle);
 	const struct vec2i backPicSize = svec2i(AMMO_WIDTH - 1, backPic->size.y);
 
 	// Aligned to the right
@@ -388,7 +395,7 @@ static void DrawWeaponStatus(
 		// Draw ammo level as inner fill
 		if (amount > 0)
 		{
-			const Pic *fillPic = PicManagerGetPic(pm, "hud/gauge_small_inner");
+			const Pic *fillPic = PicHandleGet(&fillPicHandle);
 			const int ammoMax = ammo->Max ? ammo->Max : amount;
 			const struct vec2i fillPicSize = svec2i(
 				MAX(1, (AMMO_WIDTH - 1) * amount / ammoMax), fillPic->size.y);
@@ -430,7 +437,7 @@ static void DrawWeaponStatus(
 		if (weapon->barrels[i].lock > 0)
 		{
 			const int maxLock = weapon->Gun->Lock;
-			const Pic *ballPic = PicManagerGetPic(pm, "hud/gauge_small_ball");
+			const Pic *ballPic = PicHandleGet(&ballPicHandle);
 			const int ballAreaWidth = AMMO_WIDTH - 6;
 			const struct vec2i ballPos = svec2i(
 				pos.x +
@@ -818,7 +825,8 @@ static void DrawCompassArrow(
 	const color_t tintedMask = ColorTint(mask, hsv);
 	struct vec2i textPos = svec2i_zero();
 	struct vec2i drawPos = svec2i_zero();
-	const Pic *p = PicManagerGetPic(&gPicManager, "hud/arrow");
+	static PicHandle arrowPic = PIC_HANDLE("hud/arrow");
+	const Pic *p = PicHandleGet(&arrowPic);
 	// Find which edge of screen is the best
 	bool draw = false;
 	if (compassV.x != 0)
@@ -32,6 +32,8 @@
 #include "game_events.h"
 #include "net_util.h"
 
+static ConfigHandle sSightRangeConfig = CONFIG_HANDLE("Game.SightRange");
+
 
 void LOSInit(Map *map)
 {
@@ -109,7 +111,7 @@ void LOSCalcFrom(Map *map, const struct vec2i pos, const bool explore)
 		}
 	}
 
-	const int sightRange = ConfigGetInt(&gConfig, "Game.SightRange");
+	const int sightRange = ConfigHandleInt(&sSightRangeConfig);
 	if (sightRange == 0) return;
 
 	// Limit the perimeter to the sight range
@@ -58,6 +58,7 @@
 #include "collision/collision.h"
 #include "config.h"
 #include "door.h"
+#include "draw/floor_chunks.h"
 #include "game_events.h"
 #include "gamedata.h"
 #include "log.h"
@@ -235,6 +236,12 @@ struct vec2 MapGetRandomPos(const Map *map)
 		}
 	}
 }
+struct vec2 MapGetRandomPosInTile(const struct vec2i tile)
+{
+	return svec2(
+		tile.x * TILE_WIDTH + RAND_FLOAT(0, TILE_WIDTH - 1),
+		tile.y * TILE_HEIGHT + RAND_FLOAT(0, TILE_HEIGHT - 1));
+}
 
 static void MapChangeFloor(
 	Map *map, const struct vec2i pos, const TileClass *normal,
@@ -405,8 +412,13 @@ static int GetPlacementRetries(
 
 bool MapPlaceRandomTile(
 	MapBuilder *mb, const PlacementAccessFlags paFlags,
-	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, void *), void *data)
+	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, const void *),
+	const void *data)
 {
+	if (mb->candidates[PLACEMENT_ACCESS_ANY].elemSize != 0)
+	{
+		return MapBuilderTryCandidates(mb, paFlags, tryPlaceFunc, data);
+	}
 	// Try a bunch of times to place something on a random tile
 	bool locked, unlocked;
 	const int retries =
@@ -425,28 +437,130 @@ bool MapPlaceRandomTile(
 	}
 	return false;
 }
+#define PLACE_RANDOM_POS_RETRIES 100
 bool MapPlaceRandomPos(
 	const Map *map, const PlacementAccessFlags paFlags,
 	bool (*tryPlaceFunc)(const Map *, const struct vec2, void *), void *data)
 {
 	// Try a bunch of times to place something at a random location
-	bool locked, unlocked;
-	const int retries = GetPlacementRetries(map, paFlags, &locked, &unlocked);
-	for (int i = 0; i < retries; i++)
+	// Spawn tiles are already filtered by access, so every try is on floor
+	for (int i = 0; i < PLACE_RANDOM_POS_RETRIES; i++)
 	{
-		const struct vec2 v = MapGetRandomPos(map);
-		const bool isInLocked = MapPosIsInLockedRoom(map, v);
-		if ((!locked || isInLocked) && (!unlocked || !isInLocked))
+		struct vec2 v;
+		if (!MapGetRandomSpawnPos(map, paFlags, &v))
 		{
-			if (tryPlaceFunc(map, v, data))
-			{
-				return true;
-			}
+			return false;
+		}
+		if (tryPlaceFunc(map, v, data))
+		{
+			return true;
 		}
 	}
 	return false;
 }
 
+static bool IsSpawnTile(const Tile *t)
+{
+	return t->Class->Type == TILE_CLASS_FLOOR && TileCanWalk(t);
+}
+static PlacementAccessFlags GetSpawnTileAccess(
+	const Map *map, const struct vec2i pos)
+{
+	return MapGetAccessLevel(map, pos) != 0 ? PLACEMENT_ACCESS_LOCKED
+											: PLACEMENT_ACCESS_NOT_LOCKED;
+}
+static void SpawnTilesAdd(
+	Map *map, const PlacementAccessFlags list, const int slot,
+	const struct vec2i pos)
+{
+	MapSpawnIndex *si =
+		CArrayGet(&map->spawnIndices, pos.y * map->Size.x + pos.x);
+	si->Indices[slot] = (int)map->spawnTiles[list].size;
+	CArrayPushBack(&map->spawnTiles[list], &pos);
+}
+static void SpawnTilesRemove(
+	Map *map, const PlacementAccessFlags list, const int slot,
+	const struct vec2i pos)
+{
+	// Swap with the last tile
+	CArray *tiles = &map->spawnTiles[list];
+	MapSpawnIndex *si =
+		CArrayGet(&map->spawnIndices, pos.y * map->Size.x + pos.x);
+	const int i = si->Indices[slot];
+	const struct vec2i last =
+		*(const struct vec2i *)CArrayGet(tiles, tiles->size - 1);
+	CArraySet(tiles, i, &last);
+	MapSpawnIndex *siLast =
+		CArrayGet(&map->spawnIndices, last.y * map->Size.x + last.x);
+	siLast->Indices[slot] = i;
+	CArrayPopBack(tiles);
+	si->Indices[slot] = -1;
+}
+void MapSetupSpawnTiles(Map *map)
+{
+	for (int i = 0; i <= PLACEMENT_ACCESS_NOT_LOCKED; i++)
+	{
+		CArrayTerminate(&map->spawnTiles[i]);
+		CArrayInit(&map->spawnTiles[i], sizeof(struct vec2i));
+	}
+	CArrayTerminate(&map->spawnIndices);
+	const MapSpawnIndex none = {{-1, -1}};
+	CArrayInitFill(
+		&map->spawnIndices, sizeof(MapSpawnIndex), map->Size.x * map->Size.y,
+		&none);
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), map->Size))
+	MapUpdateSpawnTile(map, _v);
+	RECT_FOREACH_END()
+}
+void MapUpdateSpawnTile(Map *map, const struct vec2i pos)
+{
+	if (map->spawnIndices.size == 0)
+	{
+		return;
+	}
+	const MapSpawnIndex *si =
+		CArrayGet(&map->spawnIndices, pos.y * map->Size.x + pos.x);
+	const bool wasSpawn = si->Indices[0] >= 0;
+	const bool isSpawn = IsSpawnTile(MapGetTile(map, pos));
+	if (wasSpawn == isSpawn)
+	{
+		return;
+	}
+	const PlacementAccessFlags access = GetSpawnTileAccess(map, pos);
+	if (isSpawn)
+	{
+		SpawnTilesAdd(map, PLACEMENT_ACCESS_ANY, 0, pos);
+		SpawnTilesAdd(map, access, 1, pos);
+	}
+	else
+	{
+		SpawnTilesRemove(map, PLACEMENT_ACCESS_ANY, 0, pos);
+		SpawnTilesRemove(map, access, 1, pos);
+	}
+}
+PlacementAccessFlags MapGetSpawnTilesIndex(
+	const Map *map, const PlacementAccessFlags paFlags)
+{
+	// Without locked rooms, locked placement can go anywhere
+	return paFlags == PLACEMENT_ACCESS_LOCKED &&
+				   map->spawnTiles[paFlags].size == 0
+			   ? PLACEMENT_ACCESS_ANY
+			   : paFlags;
+}
+bool MapGetRandomSpawnPos(
+	const Map *map, const PlacementAccessFlags paFlags, struct vec2 *out)
+{
+	const CArray *tiles =
+		&map->spawnTiles[MapGetSpawnTilesIndex(map, paFlags)];
+	if (tiles->size == 0)
+	{
+		return false;
+	}
+	const struct vec2i *tile = CArrayGet(tiles, rand() % (int)tiles->size);
+	*out = MapGetRandomPosInTile(*tile);
+	return true;
+}
+
 // TODO: use enum instead of flag for map access
 uint16_t AccessCodeToFlags(const uint16_t code)
 {
@@ -499,8 +613,14 @@ void MapTerminate(Map *map)
 	}
 	CArrayTerminate(&map->Tiles);
 	TileClassesTerminate(map->TileClasses);
+	FloorChunksInvalidate();
 	LOSTerminate(&map->LOS);
 	CArrayTerminate(&map->access);
+	for (int i = 0; i <= PLACEMENT_ACCESS_NOT_LOCKED; i++)
+	{
+		CArrayTerminate(&map->spawnTiles[i]);
+	}
+	CArrayTerminate(&map->spawnIndices);
 	PathCacheTerminate(&gPathCache);
 }
 
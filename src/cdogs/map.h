@@ -95,6 +95,14 @@ typedef struct
 	bool Hidden;
 } Exit;
 
+// Index of a tile in the spawn tile lists, or -1 if it isn't in them;
+// the first is for PLACEMENT_ACCESS_ANY, the second for the list matching
+// the tile's locked status
+typedef struct
+{
+	int Indices[2];
+} MapSpawnIndex;
+
 typedef struct
 {
 	map_t TileClasses;
@@ -114,6 +122,11 @@ typedef struct
 	CArray exits; // of Exit
 
 	int NumExplorableTiles;
+
+	// Floor tiles for picking random spawn positions in O(1),
+	// indexed by PlacementAccessFlags
+	CArray spawnTiles[PLACEMENT_ACCESS_NOT_LOCKED + 1]; // of struct vec2i
+	CArray spawnIndices; // of MapSpawnIndex, per tile
 } Map;
 
 extern Map gMap;
@@ -148,9 +161,22 @@ void MapShowExitArea(Map *map, const int i);
 struct vec2 MapGetExitPos(const Map *m, const int i);
 struct vec2i MapGetRandomTile(const Map *map);
 struct vec2 MapGetRandomPos(const Map *map);
+struct vec2 MapGetRandomPosInTile(const struct vec2i tile);
 bool MapPlaceRandomPos(
 	const Map *map, const PlacementAccessFlags paFlags,
 	bool (*tryPlaceFunc)(const Map *, const struct vec2, void *), void *data);
+// Spawn tiles are walkable floor tiles, kept up to date as tiles change.
+// They are also the candidates for placing things when building the map.
+// Other conditions, such as players nearby or things in the way, change
+// every frame and are checked by callers.
+void MapSetupSpawnTiles(Map *map);
+void MapUpdateSpawnTile(Map *map, const struct vec2i pos);
+// Index of the spawn tile list to use for placement access flags
+PlacementAccessFlags MapGetSpawnTilesIndex(
+	const Map *map, const PlacementAccessFlags paFlags);
+// Get a random position on a spawn tile; returns false if there are none
+bool MapGetRandomSpawnPos(
+	const Map *map, const PlacementAccessFlags paFlags, struct vec2 *out);
 
 void MapMarkAsVisited(Map *map, struct vec2i pos);
 void MapMarkAllAsVisited(Map *map);
@@ -228,6 +228,7 @@ static void LoadArchivePics(PicManager *pm, map_t cc, const char *archive)
 		pm, path, NULL, pm->customPics, pm->customSprites, false);
 	sprintf(path, "%s/graphics_hd", archive);
 	PicManagerLoadDir(pm, path, NULL, pm->customPics, pm->customSprites, true);
+	PicManagerPackAtlas(pm);
 	CharSpriteClassesLoadDir(cc, archive);
 }
 
@@ -74,53 +74,109 @@ void MapBuild(
 	const CharacterStore *characters)
 {
 	MapBuilder mb;
-	MapBuilderInit(&mb, m, mission, mode, characters);
-	MapInit(mb.Map, mb.mission->Size);
+	MapBuildStart(
+		&mb, m, mission, loadDynamic, missionIndex, mode, characters);
+	// Run every stage at once
+	while (MapBuildStep(&mb))
+	{
+	}
+	MapBuilderTerminate(&mb);
+}
+void MapBuildStart(
+	MapBuilder *mb, Map *m, const Mission *mission, const bool loadDynamic,
+	const int missionIndex, const GameMode mode,
+	const CharacterStore *characters)
+{
+	MapBuilderInit(mb, m, mission, mode, characters);
+	mb->stage = MAP_BUILD_STAGE_TILES;
+	mb->loadDynamic = loadDynamic;
+	mb->missionIndex = missionIndex;
+}
+static void MapBuildTiles(MapBuilder *mb);
+static void MapBuildExits(MapBuilder *mb);
+bool MapBuildStep(MapBuilder *mb)
+{
+	if (mb->stage > MAP_BUILD_STAGE_TILES)
+	{
+		// Each stage continues from a seed drawn at the end of the last, so
+		// other rand() calls between stages can't change the map
+		srand(mb->seed);
+	}
+	switch (mb->stage)
+	{
+	case MAP_BUILD_STAGE_TILES:
+		MapBuildTiles(mb);
+		break;
+	case MAP_BUILD_STAGE_SETUP:
+		MapSetupTilesAndWalls(mb);
+		MapSetupDoors(mb);
+		MapPrintDebug(mb->Map);
+		break;
+	case MAP_BUILD_STAGE_EXITS:
+		MapBuildExits(mb);
+		break;
+	case MAP_BUILD_STAGE_DYNAMIC:
+		if (mb->loadDynamic)
+		{
+			MapBuilderSetupCandidates(mb);
+			MapLoadDynamic(mb);
+			ActorsPilotVehicles();
+		}
+		break;
+	default:
+		return false;
+	}
+	mb->seed = (unsigned int)rand();
+	mb->stage++;
+	return mb->stage != MAP_BUILD_STAGE_DONE;
+}
+static void MapBuildTiles(MapBuilder *mb)
+{
+	MapInit(mb->Map, mb->mission->Size);
 
-	switch (mb.mission->Type)
+	switch (mb->mission->Type)
 	{
 	case MAPTYPE_CLASSIC:
-		MapClassicLoad(&mb);
+		MapClassicLoad(mb);
 		break;
 	case MAPTYPE_STATIC:
-		MapStaticLoad(&mb);
+		MapStaticLoad(mb);
 		break;
 	case MAPTYPE_CAVE:
-		MapCaveLoad(&mb);
+		MapCaveLoad(mb);
 		break;
 	case MAPTYPE_INTERIOR:
-		MapInteriorLoad(&mb, missionIndex);
+		MapInteriorLoad(mb, mb->missionIndex);
 		break;
 	default:
 		CASSERT(false, "unknown map type");
 		break;
 	}
-	CArrayCopy(&mb.Map->access, &mb.access);
-
-	MapSetupTilesAndWalls(&mb);
-	MapSetupDoors(&mb);
-	MapPrintDebug(mb.Map);
-
+	CArrayCopy(&mb->Map->access, &mb->access);
+}
+static void MapBuildExits(MapBuilder *mb)
+{
 	// Set exit now since we have set up all the tiles
-	switch (mb.mission->Type)
+	switch (mb->mission->Type)
 	{
 	case MAPTYPE_CLASSIC:
-		MapAddDrains(&mb);
-		if (HasExit(gCampaign.Entry.Mode) && mb.mission->u.Classic.ExitEnabled)
+		MapAddDrains(mb);
+		if (HasExit(gCampaign.Entry.Mode) &&
+			mb->mission->u.Classic.ExitEnabled)
 		{
-			MapGenerateRandomExitArea(mb.Map, missionIndex);
+			MapGenerateRandomExitArea(mb->Map, mb->missionIndex);
 		}
 		break;
 	case MAPTYPE_STATIC:
 		break;
 	case MAPTYPE_CAVE:
-		if (HasExit(gCampaign.Entry.Mode) && mb.mission->u.Cave.ExitEnabled)
+		if (HasExit(gCampaign.Entry.Mode) && mb->mission->u.Cave.ExitEnabled)
 		{
-			MapGenerateRandomExitArea(mb.Map, missionIndex);
+			MapGenerateRandomExitArea(mb->Map, mb->missionIndex);
 		}
 		break;
 	case MAPTYPE_INTERIOR:
-		MapAddDrains(&mb);
+		MapAddDrains(mb);
 		break;
 	default:
 		CASSERT(false, "unknown map type");
@@ -128,25 +184,19 @@ void MapBuild(
 	}
 
 	// Count total number of reachable tiles, for explored %
-	mb.Map->NumExplorableTiles = 0;
+	mb->Map->NumExplorableTiles = 0;
 	struct vec2i v;
-	for (v.y = 0; v.y < mb.Map->Size.y; v.y++)
+	for (v.y = 0; v.y < mb->Map->Size.y; v.y++)
 	{
-		for (v.x = 0; v.x < mb.Map->Size.x; v.x++)
+		for (v.x = 0; v.x < mb->Map->Size.x; v.x++)
 		{
-			if (TileCanWalk(MapGetTile(mb.Map, v)))
+			if (TileCanWalk(MapGetTile(mb->Map, v)))
 			{
-				mb.Map->NumExplorableTiles++;
+				mb->Map->NumExplorableTiles++;
 			}
 		}
 	}
-
-	if (loadDynamic)
-	{
-		MapLoadDynamic(&mb);
-		ActorsPilotVehicles();
-	}
-	MapBuilderTerminate(&mb);
+	MapSetupSpawnTiles(mb->Map);
 }
 void SetupWallTileClasses(Map *m, PicManager *pm, const TileClass *base)
 {
@@ -253,6 +303,12 @@ void MapBuilderTerminate(MapBuilder *mb)
 	CArrayTerminate(&mb->access);
 	CArrayTerminate(&mb->tiles);
 	CArrayTerminate(&mb->leaveFree);
+	for (int i = 0; i <= PLACEMENT_ACCESS_NOT_LOCKED; i++)
+	{
+		CArrayTerminate(&mb->candidates[i]);
+	}
+	CArrayTerminate(&mb->wallsAdjacent);
+	CArrayTerminate(&mb->wallsAround);
 }
 
 uint16_t MapBuildGetAccess(const MapBuilder *mb, const struct vec2i pos)
@@ -292,6 +348,10 @@ static bool IsTileOKStrict(
 	const int numWallsAround);
 static int MapGetNumWallsAdjacentTile(const Map *map, const struct vec2i v);
 static int MapGetNumWallsAroundTile(const Map *map, const struct vec2i v);
+static int MapBuilderGetNumWallsAdjacent(
+	const MapBuilder *mb, const struct vec2i v);
+static int MapBuilderGetNumWallsAround(
+	const MapBuilder *mb, const struct vec2i v);
 bool MapTryPlaceOneObject(
 	MapBuilder *mb, const struct vec2i v, const MapObject *mo,
 	const int extraFlags, const bool isStrictMode)
@@ -309,8 +369,8 @@ bool MapTryPlaceOneObject(
 	if (isStrictMode &&
 		!IsTileOKStrict(
 			mo, t, tAbove, tBelow, MapBuilderIsLeaveFree(mb, v),
-			MapGetNumWallsAdjacentTile(mb->Map, v),
-			MapGetNumWallsAroundTile(mb->Map, v)))
+			MapBuilderGetNumWallsAdjacent(mb, v),
+			MapBuilderGetNumWallsAround(mb, v)))
 	{
 		return false;
 	}
@@ -428,9 +488,82 @@ static int MapGetNumWallsAroundTile(const Map *map, const struct vec2i v)
 	}
 	return count;
 }
+static int MapBuilderGetNumWallsAdjacent(
+	const MapBuilder *mb, const struct vec2i v)
+{
+	if (mb->wallsAdjacent.size == 0)
+	{
+		return MapGetNumWallsAdjacentTile(mb->Map, v);
+	}
+	return *(const uint8_t *)CArrayGet(
+		&mb->wallsAdjacent, v.y * mb->Map->Size.x + v.x);
+}
+static int MapBuilderGetNumWallsAround(
+	const MapBuilder *mb, const struct vec2i v)
+{
+	if (mb->wallsAround.size == 0)
+	{
+		return MapGetNumWallsAroundTile(mb->Map, v);
+	}
+	return *(const uint8_t *)CArrayGet(
+		&mb->wallsAround, v.y * mb->Map->Size.x + v.x);
+}
+
+void MapBuilderSetupCandidates(MapBuilder *mb)
+{
+	const int mapSize = mb->Map->Size.x * mb->Map->Size.y;
+	// Work on copies of the map's spawn tiles, so used tiles can be removed
+	for (int i = 0; i <= PLACEMENT_ACCESS_NOT_LOCKED; i++)
+	{
+		CArrayCopy(&mb->candidates[i], &mb->Map->spawnTiles[i]);
+	}
+	CArrayTerminate(&mb->wallsAdjacent);
+	CArrayTerminate(&mb->wallsAround);
+	CArrayInitFillZero(&mb->wallsAdjacent, sizeof(uint8_t), mapSize);
+	CArrayInitFillZero(&mb->wallsAround, sizeof(uint8_t), mapSize);
+	const Rect2i r = Rect2iNew(svec2i_zero(), mb->Map->Size);
+	RECT_FOREACH(r)
+	// Wall counts only depend on tile classes, which don't change once
+	// objects start being placed
+	const uint8_t adjacent = (uint8_t)MapGetNumWallsAdjacentTile(mb->Map, _v);
+	const uint8_t around = (uint8_t)MapGetNumWallsAroundTile(mb->Map, _v);
+	CArraySet(&mb->wallsAdjacent, _i, &adjacent);
+	CArraySet(&mb->wallsAround, _i, &around);
+	RECT_FOREACH_END()
+}
+
+bool MapBuilderTryCandidates(
+	MapBuilder *mb, const PlacementAccessFlags paFlags,
+	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, const void *),
+	const void *data)
+{
+	CArray *candidates =
+		&mb->candidates[MapGetSpawnTilesIndex(mb->Map, paFlags)];
+	// Partial Fisher-Yates: each candidate is tried at most once
+	for (int i = 0; i < (int)candidates->size; i++)
+	{
+		const int j = RAND_INT(i, (int)candidates->size);
+		struct vec2i *vi = CArrayGet(candidates, i);
+		struct vec2i *vj = CArrayGet(candidates, j);
+		const struct vec2i tilePos = *vj;
+		*vj = *vi;
+		*vi = tilePos;
+		if (tryPlaceFunc(mb, tilePos, data))
+		{
+			// Remove the used tile so later placements skip it
+			*vi = *(const struct vec2i *)CArrayGet(
+				candidates, candidates->size - 1);
+			CArrayPopBack(candidates);
+			return true;
+		}
+	}
+	return false;
+}
 
 static void AddObjectives(MapBuilder *mb);
 static void AddKeys(MapBuilder *mb);
+static bool TryPlacePickup(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data);
 void MapLoadDynamic(MapBuilder *mb)
 {
 	if (mb->mission->Type == MAPTYPE_STATIC)
@@ -449,16 +582,8 @@ void MapLoadDynamic(MapBuilder *mb)
 	CA_FOREACH(const PickupCount, pc, mb->mission->PickupCounts)
 	for (int j = 0; j < pc->Count; j++)
 	{
-		for (int i = 0; i < 1000; i++)
-		{
-			const struct vec2 v = MapGetRandomPos(mb->Map);
-			const struct vec2i size = svec2i(COLLECTABLE_W, COLLECTABLE_H);
-			if (!IsCollisionWithWall(v, size))
-			{
-				MapPlacePickup(pc->P, v, 0);
-				break;
-			}
-		}
+		MapBuilderTryCandidates(
+			mb, PLACEMENT_ACCESS_ANY, TryPlacePickup, pc->P);
 	}
 	CA_FOREACH_END()
 
@@ -472,6 +597,18 @@ void MapLoadDynamic(MapBuilder *mb)
 		AddKeys(mb);
 	}
 }
+static bool TryPlacePickup(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data)
+{
+	UNUSED(mb);
+	const struct vec2 v = MapGetRandomPosInTile(tilePos);
+	if (IsCollisionWithWall(v, svec2i(COLLECTABLE_W, COLLECTABLE_H)))
+	{
+		return false;
+	}
+	MapPlacePickup(data, v, 0);
+	return true;
+}
 static bool MapTryPlaceBlowup(
 	MapBuilder *mb, const int objective, const bool strict);
 static int MapTryPlaceCollectible(MapBuilder *mb, const int objective);
@@ -518,30 +655,25 @@ static void AddObjectives(MapBuilder *mb)
 	}
 	CA_FOREACH_END()
 }
+static bool TryPlaceOneCollectible(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data);
 static int MapTryPlaceCollectible(MapBuilder *mb, const int objective)
 {
 	const Objective *o = CArrayGet(&mb->mission->Objectives, objective);
-	const bool hasLockedRooms =
-		(o->Flags & OBJECTIVE_HIACCESS) && MapHasLockedRooms(mb->Map);
-	const bool noaccess = o->Flags & OBJECTIVE_NOACCESS;
-	int i = (noaccess || hasLockedRooms) ? 1000 : 100;
-
-	while (i)
+	return MapBuilderTryCandidates(
+		mb, ObjectiveGetPlacementAccessFlags(o), TryPlaceOneCollectible,
+		&objective);
+}
+static bool TryPlaceOneCollectible(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data)
+{
+	const struct vec2 v = MapGetRandomPosInTile(tilePos);
+	if (IsCollisionWithWall(v, svec2i(COLLECTABLE_W, COLLECTABLE_H)))
 	{
-		const struct vec2 v = MapGetRandomPos(mb->Map);
-		const struct vec2i size = svec2i(COLLECTABLE_W, COLLECTABLE_H);
-		if (!IsCollisionWithWall(v, size))
-		{
-			if ((!hasLockedRooms || MapPosIsInLockedRoom(mb->Map, v)) &&
-				(!noaccess || !MapPosIsInLockedRoom(mb->Map, v)))
-			{
-				MapPlaceCollectible(mb->mission, objective, v);
-				return 1;
-			}
-		}
-		i--;
+		return false;
 	}
-	return 0;
+	MapPlaceCollectible(mb->mission, *(const int *)data, v);
+	return true;
 }
 static void MapPlaceCard(
 	MapBuilder *mb, const int keyIndex, const int mapAccess);
@@ -564,23 +696,40 @@ static void AddKeys(MapBuilder *mb)
 		MapPlaceCard(mb, 0, 0);
 	}
 }
+typedef struct
+{
+	int keyIndex;
+	int mapAccess;
+} TryPlaceCardData;
+static bool TryPlaceCard(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data);
 static void MapPlaceCard(
 	MapBuilder *mb, const int keyIndex, const int mapAccess)
 {
-	for (;;)
+	TryPlaceCardData data;
+	data.keyIndex = keyIndex;
+	data.mapAccess = mapAccess;
+	if (!MapBuilderTryCandidates(
+			mb, PLACEMENT_ACCESS_ANY, TryPlaceCard, &data))
 	{
-		const struct vec2i v = MapGetRandomTile(mb->Map);
-		const Tile *t = MapGetTile(mb->Map, v);
-		if (t->Class->IsRoom && TileIsClear(t) && TileCanWalk(t) &&
-			MapBuildGetAccess(mb, v) == mapAccess &&
-			// Ensure keys are visible, not hidden behind walls
-			TileIsClear(MapGetTile(mb->Map, svec2i(v.x, v.y + 1))))
-		{
-			MapPlaceKey(mb, v, keyIndex);
-			return;
-		}
+		LOG(LM_MAP, LL_ERROR, "cannot place key %d", keyIndex);
 	}
 }
+static bool TryPlaceCard(
+	MapBuilder *mb, const struct vec2i tilePos, const void *data)
+{
+	const TryPlaceCardData *pData = data;
+	const Tile *t = MapGetTile(mb->Map, tilePos);
+	if (t->Class->IsRoom && TileIsClear(t) && TileCanWalk(t) &&
+		MapBuildGetAccess(mb, tilePos) == pData->mapAccess &&
+		// Ensure keys are visible, not hidden behind walls
+		TileIsClear(MapGetTile(mb->Map, svec2i(tilePos.x, tilePos.y + 1))))
+	{
+		MapPlaceKey(mb, tilePos, pData->keyIndex);
+		return true;
+	}
+	return false;
+}
 typedef struct
 {
 	const Objective *o;
@@ -588,7 +737,7 @@ typedef struct
 	bool strict;
 } TryPlaceOneBlowupData;
 static bool TryPlaceOneBlowup(
-	MapBuilder *mb, const struct vec2i tilePos, void *data);
+	MapBuilder *mb, const struct vec2i tilePos, const void *data);
 static bool MapTryPlaceBlowup(
 	MapBuilder *mb, const int objective, const bool strict)
 {
@@ -601,7 +750,7 @@ static bool MapTryPlaceBlowup(
 	return MapPlaceRandomTile(mb, paFlags, TryPlaceOneBlowup, &data);
 }
 static bool TryPlaceOneBlowup(
-	MapBuilder *mb, const struct vec2i tilePos, void *data)
+	MapBuilder *mb, const struct vec2i tilePos, const void *data)
 {
 	const TryPlaceOneBlowupData *pData = data;
 	return MapTryPlaceDestroyObject(
@@ -52,6 +52,16 @@
 #include "map.h"
 #include "mission.h"
 
+// Stages of building a map, so that it can be spread over several frames
+typedef enum
+{
+	MAP_BUILD_STAGE_TILES,	 // generate the tiles for the map type
+	MAP_BUILD_STAGE_SETUP,	 // set up walls and doors
+	MAP_BUILD_STAGE_EXITS,	 // add exits and drains, find spawn tiles
+	MAP_BUILD_STAGE_DYNAMIC, // place objects, pickups and actors
+	MAP_BUILD_STAGE_DONE
+} MapBuildStage;
+
 typedef struct
 {
 	Map *Map;
@@ -59,14 +69,33 @@ typedef struct
 	GameMode mode;
 	const CharacterStore *characters;
 
+	// Progress of a staged build
+	MapBuildStage stage;
+	bool loadDynamic;
+	int missionIndex;
+	unsigned int seed; // seeds rand() for the next stage
+
 	// internal data structures to help build the map
 	CArray access;	  // of uint16_t
 	CArray tiles;	  // of TileClass
 	CArray leaveFree; // of bool
+
+	// Candidate tiles for random placement, indexed by PlacementAccessFlags
+	// Copied from the map's spawn tiles once the tiles and walls are set up
+	CArray candidates[PLACEMENT_ACCESS_NOT_LOCKED + 1]; // of struct vec2i
+	CArray wallsAdjacent;								 // of uint8_t
+	CArray wallsAround;									 // of uint8_t
 } MapBuilder;
 
 void MapBuild(
 	Map *m, const Mission *mission, const bool loadDynamic, const int missionIndex, const GameMode mode, const CharacterStore *characters);
+// Build a map one stage at a time; MapBuildStep runs the next stage and
+// returns false once the map is complete. Terminate the builder afterwards.
+void MapBuildStart(
+	MapBuilder *mb, Map *m, const Mission *mission, const bool loadDynamic,
+	const int missionIndex, const GameMode mode,
+	const CharacterStore *characters);
+bool MapBuildStep(MapBuilder *mb);
 void MapBuilderInit(
 	MapBuilder *mb, Map *m, const Mission *mission, const GameMode mode, const CharacterStore *characters);
 void MapBuilderTerminate(MapBuilder *mb);
@@ -84,6 +113,16 @@ void MapBuilderSetLeaveFree(
 	MapBuilder *mb, const struct vec2i tile, const bool value);
 bool MapBuilderIsLeaveFree(const MapBuilder *mb, const struct vec2i tile);
 
+// Copy the map's spawn tiles into the candidate lists used for random
+// placement, and count the walls around each tile
+void MapBuilderSetupCandidates(MapBuilder *mb);
+// Try candidate tiles in random order, without replacement, until one is
+// accepted; the accepted tile is removed from the candidates
+bool MapBuilderTryCandidates(
+	MapBuilder *mb, const PlacementAccessFlags paFlags,
+	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, const void *),
+	const void *data);
+
 bool MapTryPlaceOneObject(
 	MapBuilder *mb, const struct vec2i v, const MapObject *mo,
 	const int extraFlags, const bool isStrictMode);
@@ -99,8 +138,8 @@ void MapPlaceKey(
 	MapBuilder *mb, const struct vec2i tilePos, const int keyIndex);
 bool MapPlaceRandomTile(
 	MapBuilder *mb, const PlacementAccessFlags paFlags,
-	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, void *),
-	void *data);
+	bool (*tryPlaceFunc)(MapBuilder *, const struct vec2i, const void *),
+	const void *data);
 
 bool MapIsAreaInside(
 	const Map *map, const struct vec2i pos, const struct vec2i size);
@@ -31,8 +31,9 @@
 #include "log.h"
 #include "map_build.h"
 
-static void CaveRep(MapBuilder *mb, const int r1, const int r2);
-static void LinkDisconnectedAreas(MapBuilder *mb);
+// Padding around the wall bitmap, enough for the 5x5 automaton window
+#define CAVE_BITMAP_PAD 2
+static void LinkDisconnectedAreas(MapBuilder *mb, const CaveBitmap *walls);
 static void FixCorridors(MapBuilder *mb, const int corridorWidth);
 static void PlaceSquares(MapBuilder *mb, const int squares);
 static void PlaceRooms(MapBuilder *mb);
@@ -53,12 +54,36 @@ void MapCaveLoad(MapBuilder *mb)
 	// Shuffle
 	CArrayShuffle(&mb->tiles);
 	// Repetitions
+	// Run on double-buffered wall bitmaps, writing tiles once at the end
+	CaveBitmap bitmaps[2];
+	CaveBitmapInit(&bitmaps[0], mb->Map->Size);
+	CaveBitmapInit(&bitmaps[1], mb->Map->Size);
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
+	CaveBitmapSet(
+		&bitmaps[0], _v, MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL);
+	RECT_FOREACH_END()
+	int cur = 0;
 	for (int i = 0; i < mb->mission->u.Cave.Repeat; i++)
 	{
-		CaveRep(mb, mb->mission->u.Cave.R1, mb->mission->u.Cave.R2);
+		CaveBitmapStep(
+			&bitmaps[cur], &bitmaps[1 - cur], mb->mission->u.Cave.R1,
+			mb->mission->u.Cave.R2);
+		cur = 1 - cur;
+	}
+	if (mb->mission->u.Cave.Repeat > 0)
+	{
+		RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
+		MapBuilderSetTile(
+			mb, _v,
+			CaveBitmapGet(&bitmaps[cur], _v)
+				? &mb->mission->u.Cave.TileClasses.Wall
+				: &mb->mission->u.Cave.TileClasses.Floor);
+		RECT_FOREACH_END()
 	}
 
-	LinkDisconnectedAreas(mb);
+	LinkDisconnectedAreas(mb, &bitmaps[cur]);
+	CaveBitmapTerminate(&bitmaps[0]);
+	CaveBitmapTerminate(&bitmaps[1]);
 
 	FixCorridors(mb, mb->mission->u.Cave.CorridorWidth);
 
@@ -67,104 +92,181 @@ void MapCaveLoad(MapBuilder *mb)
 	PlaceRooms(mb);
 }
 
+void CaveBitmapInit(CaveBitmap *b, const struct vec2i size)
+{
+	b->size = size;
+	// Extra word per row so that windows can always read the next word
+	b->stride = (size.x + 2 * CAVE_BITMAP_PAD) / 64 + 2;
+	const size_t len =
+		(size_t)b->stride * (size.y + 2 * CAVE_BITMAP_PAD) * sizeof *b->bits;
+	CMALLOC(b->bits, len);
+	// Everything starts as wall, including the padding
+	memset(b->bits, 0xff, len);
+}
+void CaveBitmapTerminate(CaveBitmap *b)
+{
+	CFREE(b->bits);
+}
+bool CaveBitmapGet(const CaveBitmap *b, const struct vec2i pos)
+{
+	const int x = pos.x + CAVE_BITMAP_PAD;
+	const int y = pos.y + CAVE_BITMAP_PAD;
+	return (b->bits[y * b->stride + x / 64] >> (x % 64)) & 1;
+}
+void CaveBitmapSet(CaveBitmap *b, const struct vec2i pos, const bool wall)
+{
+	const int x = pos.x + CAVE_BITMAP_PAD;
+	const int y = pos.y + CAVE_BITMAP_PAD;
+	uint64_t *w = &b->bits[y * b->stride + x / 64];
+	const uint64_t mask = (uint64_t)1 << (x % 64);
+	if (wall)
+	{
+		*w |= mask;
+	}
+	else
+	{
+		*w &= ~mask;
+	}
+}
+// Get the 5 bits starting at padded column x of padded row y
+static int CaveBitmapRow5(const CaveBitmap *b, const int y, const int x)
+{
+	const uint64_t *row = &b->bits[y * b->stride];
+	const int off = x % 64;
+	uint64_t w = row[x / 64] >> off;
+	if (off > 64 - 5)
+	{
+		w |= row[x / 64 + 1] << (64 - off);
+	}
+	return (int)(w & 0x1f);
+}
+
 // Perform one generation of cellular automata
 // If the number of walls within 1 distance is at least R1, OR
 // if the number of walls within 2 distance is at most R2, then the tile
 // becomes a wall; otherwise it is a floor
-static int CountWallsAround(
-	const MapBuilder *mb, const struct vec2i pos, const int d);
-static void CaveRep(MapBuilder *mb, const int r1, const int r2)
+static const int sBitCount5[32] = {
+	0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+	1, 2, 2, 3, 2, 3, 3, 4, 2, 3, 3, 4, 3, 4, 4, 5};
+void CaveBitmapStep(
+	const CaveBitmap *src, CaveBitmap *dst, const int r1, const int r2)
 {
-	CArray buf;
-	CArrayInitFill(
-		&buf, mb->tiles.elemSize, mb->tiles.size,
-		&mb->mission->u.Cave.TileClasses.Floor);
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	TileClass *tile = CArrayGet(&buf, _i);
-	if (CountWallsAround(mb, _v, 1) >= r1 || CountWallsAround(mb, _v, 2) <= r2)
+	for (int y = 0; y < src->size.y; y++)
 	{
-		*tile = mb->mission->u.Cave.TileClasses.Wall;
+		for (int x = 0; x < src->size.x; x++)
+		{
+			// Padded coordinates of the 5x5 window are (x, y)-(x+4, y+4);
+			// the 3x3 window is the middle 3 bits of the middle 3 rows
+			int c1 = 0;
+			int c2 = 0;
+			for (int dy = 0; dy < 5; dy++)
+			{
+				const int bits = CaveBitmapRow5(src, y + dy, x);
+				c2 += sBitCount5[bits];
+				if (dy >= 1 && dy <= 3)
+				{
+					c1 += sBitCount5[(bits >> 1) & 0x7];
+				}
+			}
+			CaveBitmapSet(dst, svec2i(x, y), c1 >= r1 || c2 <= r2);
+		}
 	}
-	else
+}
+
+// Union-find over tile indices, using the label array as parents.
+// Roots are always the smallest index in their set, so every parent index
+// is at most its child's.
+static int UnionFindRoot(int *parent, int i)
+{
+	while (parent[i] != i)
 	{
-		*tile = mb->mission->u.Cave.TileClasses.Floor;
+		// Path halving
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+static void UnionFindUnion(int *parent, const int a, const int b)
+{
+	const int ra = UnionFindRoot(parent, a);
+	const int rb = UnionFindRoot(parent, b);
+	if (ra < rb)
+	{
+		parent[rb] = ra;
+	}
+	else if (rb < ra)
+	{
+		parent[ra] = rb;
 	}
-	RECT_FOREACH_END()
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	MapBuilderSetTile(mb, _v, CArrayGet(&buf, _i));
-	RECT_FOREACH_END()
-	CArrayTerminate(&buf);
 }
-static int CountWallsAround(
-	const MapBuilder *mb, const struct vec2i pos, const int d)
+int CaveBitmapLabelAreas(const CaveBitmap *b, int *labels)
 {
-	int c = 0;
-	RECT_FOREACH(Rect2iNew(
-		svec2i_subtract(pos, svec2i(d, d)), svec2i(2 * d + 1, 2 * d + 1)))
-	// Also count edge of maps
-	if (!MapIsTileIn(mb->Map, _v) ||
-		MapBuilderGetTile(mb, _v)->Type == TILE_CLASS_WALL)
+	const int w = b->size.x;
+	const int n = b->size.x * b->size.y;
+	// First pass: join each floor tile with its left and top neighbours
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), b->size))
+	if (CaveBitmapGet(b, _v))
 	{
-		c++;
+		labels[_i] = -1;
+	}
+	else
+	{
+		labels[_i] = _i;
+		if (_v.x > 0 && labels[_i - 1] >= 0)
+		{
+			UnionFindUnion(labels, _i, _i - 1);
+		}
+		if (_v.y > 0 && labels[_i - w] >= 0)
+		{
+			UnionFindUnion(labels, _i, _i - w);
+		}
 	}
 	RECT_FOREACH_END()
-	return c;
+	// Second pass: replace parents with area numbers, in scan order.
+	// Parents come before their children and share their area, so they
+	// have already been numbered.
+	int numAreas = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (labels[i] < 0)
+		{
+			continue;
+		}
+		labels[i] = labels[i] == i ? numAreas++ : labels[labels[i]];
+	}
+	return numAreas;
 }
 
-static void MapFloodFill(
-	CArray *fl, const struct vec2i size, const int idx, const int elem);
 static void AddCorridor(
 	MapBuilder *mb, const struct vec2i v1, const struct vec2i v2,
 	const struct vec2i dInit, const TileClass *tile);
-static void LinkDisconnectedAreas(MapBuilder *mb)
+static void LinkDisconnectedAreas(MapBuilder *mb, const CaveBitmap *walls)
 {
-	// Use flood fill to identify disconnected areas
-	CArray fl;
-	CArrayInitFillZero(&fl, sizeof(int), mb->tiles.size);
-	// First copy across the wall tiles (as -1)
-	RECT_FOREACH(Rect2iNew(svec2i_zero(), mb->Map->Size))
-	const TileClass *tile = MapBuilderGetTile(mb, _v);
-	if (tile->Type == TILE_CLASS_WALL)
+	CArray labels;
+	CArrayInitFillZero(&labels, sizeof(int), mb->tiles.size);
+	const int numAreas = CaveBitmapLabelAreas(walls, labels.data);
+
+	// Select a random tile from each area using reservoir sampling
+	CArray areaStarts;
+	CArrayInitFillZero(&areaStarts, sizeof(int), numAreas);
+	CArray areaCounts;
+	CArrayInitFillZero(&areaCounts, sizeof(int), numAreas);
+	CA_FOREACH(const int, area, labels)
+	if (*area < 0)
 	{
-		*(int *)CArrayGet(&fl, _i) = -1;
+		continue;
 	}
-	RECT_FOREACH_END()
-	// Then perform flood fill conditionally on the flood layer
-	int idx = 1;
-	CA_FOREACH(int, i, fl)
-	if (*i == 0)
+	int *count = CArrayGet(&areaCounts, *area);
+	(*count)++;
+	if (*count == 1 || rand() % *count == 0)
 	{
-		MapFloodFill(&fl, mb->Map->Size, _ca_index, idx);
-		idx++;
+		*(int *)CArrayGet(&areaStarts, *area) = _ca_index;
 	}
 	CA_FOREACH_END()
+	CArrayTerminate(&labels);
+	CArrayTerminate(&areaCounts);
 
-	const int numAreas = idx - 1;
 	// Connect the disconnected areas, first to second, second to third etc.
-	// Select random tile from each area, using index shuffle
-	CArray areaTiles;
-	CArrayInit(&areaTiles, sizeof(int));
-	CA_FOREACH(int, i, fl)
-	UNUSED(i);
-	CArrayPushBack(&areaTiles, &_ca_index);
-	CA_FOREACH_END()
-	CArrayShuffle(&areaTiles);
-	CArray areaStarts;
-	CArrayInitFillZero(&areaStarts, sizeof(int), numAreas);
-	CA_FOREACH(int, areaIdx, areaTiles)
-	const int tile = *(int *)CArrayGet(&fl, *areaIdx) - 1;
-	if (tile >= 0 && tile < numAreas)
-	{
-		int *areaStart = CArrayGet(&areaStarts, tile);
-		if (*areaStart == 0)
-		{
-			*areaStart = *areaIdx;
-		}
-	}
-	CA_FOREACH_END()
-	CArrayTerminate(&fl);
-	CArrayTerminate(&areaTiles);
-	// Connect consecutive pairs of tiles
 	for (int i = 0; i < (int)areaStarts.size - 1; i++)
 	{
 		const int *a1 = CArrayGet(&areaStarts, i);
@@ -183,50 +285,6 @@ static void LinkDisconnectedAreas(MapBuilder *mb)
 	CArrayTerminate(&areaStarts);
 }
 
-static void MapFloodFill(
-	CArray *fl, const struct vec2i size, const int idx, const int elem)
-{
-	CArray indices;
-	CArrayInit(&indices, sizeof(int));
-	CArrayPushBack(&indices, &idx);
-	const int floodTile = *(int *)CArrayGet(fl, idx);
-	*(int *)CArrayGet(fl, idx) = elem;
-	CA_FOREACH(int, i, indices)
-	const int x = *i % size.x;
-	const int y = *i / size.x;
-	int next;
-	// top
-	next = (y - 1) * size.x + x;
-	if (y > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// bottom
-	next = (y + 1) * size.x + x;
-	if (y < size.y - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// left
-	next = y * size.x + x - 1;
-	if (x > 0 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	// right
-	next = y * size.x + x + 1;
-	if (x < size.x - 1 && *(int *)CArrayGet(fl, next) == floodTile)
-	{
-		CArrayPushBack(&indices, &next);
-		*(int *)CArrayGet(fl, next) = elem;
-	}
-	CA_FOREACH_END()
-	CArrayTerminate(&indices);
-}
-
 // Add an S-shaped corridor from one point to another, filling it with a
 // certain tile value. The corridor starts in a specific direction d, then
 // makes a turn in the middle, then turns back to the original direction.
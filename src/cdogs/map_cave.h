@@ -30,3 +30,22 @@
 #include "map_build.h"
 
 void MapCaveLoad(MapBuilder *mb);
+
+// Wall bitmap for the cellular automaton, one bit per tile, padded with
+// walls so that the edge of the map counts as walls
+typedef struct
+{
+	struct vec2i size;
+	int stride;
+	uint64_t *bits;
+} CaveBitmap;
+void CaveBitmapInit(CaveBitmap *b, const struct vec2i size);
+void CaveBitmapTerminate(CaveBitmap *b);
+bool CaveBitmapGet(const CaveBitmap *b, const struct vec2i pos);
+void CaveBitmapSet(CaveBitmap *b, const struct vec2i pos, const bool wall);
+// Perform one generation of cellular automata from src into dst
+void CaveBitmapStep(
+	const CaveBitmap *src, CaveBitmap *dst, const int r1, const int r2);
+// Label 4-connected floor areas, numbered in scan order; walls get -1.
+// labels must hold size.x * size.y ints. Returns the number of areas.
+int CaveBitmapLabelAreas(const CaveBitmap *b, int *labels);
@@ -522,22 +522,48 @@ static const CWSongType songsCampaign[] = {
 	SONG_ROSTER,  // lose
 	SONG_VICTORY, // victory
 };
-static bool LoadMusic(CWolfMap *map, MusicChunk *chunk, const int i)
+static void MusicStreamFill(void *data, Uint8 *stream, int len)
 {
-	char *data;
-	size_t len;
-	const int err = CWAudioGetMusic(&map->audio, map->type, i, &data, &len);
-	if (err != 0)
+	int16_t *out = (int16_t *)stream;
+	const int samples = len / (int)sizeof(int16_t);
+	CWAudioMusicStreamRender(data, out, samples / MUSIC_AUDIO_CHANNELS);
+	// Hooked music bypasses the mixer's music volume
+	const int volume = Mix_VolumeMusic(-1);
+	if (volume < MIX_MAX_VOLUME)
 	{
-		return false;
+		for (int i = 0; i < samples; i++)
+		{
+			out[i] = (int16_t)(out[i] * volume / MIX_MAX_VOLUME);
+		}
 	}
+}
+static bool LoadMusic(CWolfMap *map, MusicChunk *chunk, const int i)
+{
 	if (map->type == CWMAPTYPE_N3D)
 	{
+		char *data;
+		size_t len;
+		const int err =
+			CWAudioGetMusic(&map->audio, map->type, i, &data, &len);
+		if (err != 0)
+		{
+			return false;
+		}
 		SDL_RWops *rwops = SDL_RWFromMem(data, (int)len);
 		chunk->u.Music = Mix_LoadMUS_RW(rwops, 1);
 		return true;
 	}
-	chunk->u.Chunk = Mix_QuickLoad_RAW((Uint8 *)data, (Uint32)len);
+	// Synthesise the IMF music while it plays
+	CWMusicStream *stream;
+	const int err = CWAudioMusicStreamOpen(&map->audio, i, &stream);
+	if (err != 0 || stream == NULL)
+	{
+		return false;
+	}
+	chunk->isStream = true;
+	chunk->u.Stream.Fill = MusicStreamFill;
+	chunk->u.Stream.Free = (void (*)(void *))CWAudioMusicStreamFree;
+	chunk->u.Stream.Data = stream;
 	return false;
 }
 
@@ -728,7 +754,6 @@ int MapWolfLoad(
 		goto bail;
 	}
 
-	LoadSounds(&gSoundDevice, map);
 	for (int i = 0; i < MUSIC_COUNT; i++)
 	{
 		CampaignSongData *csd;
@@ -738,6 +763,7 @@ int MapWolfLoad(
 		c->CustomSongs[i].Data = csd;
 		c->CustomSongs[i].GetData = GetCampaignSong;
 		c->CustomSongs[i].isMusic = false;
+		c->CustomSongs[i].isStream = false;
 		c->CustomSongs[i].u.Chunk = NULL;
 	}
 
@@ -833,6 +859,10 @@ int MapWolfLoad(
 			&scrollShuffler);
 	}
 
+	// The sounds borrow the map's sample data, so only add them once the
+	// load can no longer fail and free it
+	LoadSounds(&gSoundDevice, map);
+
 bail:
 	if (err != 0)
 	{
@@ -844,12 +874,12 @@ bail:
 	return err;
 }
 
-static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i);
-static Mix_Chunk *LoadAdlibSoundData(const CWolfMap *map, const int i);
+static SoundChunk *LoadSoundData(const CWolfMap *map, const int i);
+static SoundChunk *LoadAdlibSoundData(const CWolfMap *map, const int i);
 static void AddNormalSound(
-	const SoundDevice *s, const char *name, Mix_Chunk *data);
+	const SoundDevice *s, const char *name, SoundChunk *data);
 static void AddRandomSound(
-	const SoundDevice *s, const char *name, Mix_Chunk *data);
+	const SoundDevice *s, const char *name, SoundChunk *data);
 static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 {
 	if (!s->isInitialised)
@@ -865,7 +895,7 @@ static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 		{
 			continue;
 		}
-		Mix_Chunk *data = LoadAdlibSoundData(map, i);
+		SoundChunk *data = LoadAdlibSoundData(map, i);
 		if (name[strlen(name) - 1] == '/')
 		{
 			AddRandomSound(s, name, data);
@@ -884,30 +914,59 @@ static void LoadSounds(const SoundDevice *s, const CWolfMap *map)
 		{
 			continue;
 		}
+		// All the aliases share the same chunk
+		SoundChunk *data = LoadSoundData(map, i);
+		if (data == NULL)
+		{
+			continue;
+		}
 		// Tokenise names
 		char *namesCopy;
 		CSTRDUP(namesCopy, names);
 		char *name = strtok(namesCopy, "|");
+		bool isFirst = true;
 		while (name != NULL)
 		{
-			Mix_Chunk *data = LoadSoundData(map, i);
-			if (data != NULL)
+			SoundChunk *sc = isFirst ? data : SoundChunkRef(data);
+			isFirst = false;
+			if (name[strlen(name) - 1] == '/')
 			{
-				if (name[strlen(name) - 1] == '/')
-				{
-					AddRandomSound(s, name, data);
-				}
-				else
-				{
-					AddNormalSound(s, name, data);
-				}
+				AddRandomSound(s, name, sc);
+			}
+			else
+			{
+				AddNormalSound(s, name, sc);
 			}
 			name = strtok(NULL, "|");
 		}
 		CFREE(namesCopy);
 	}
 }
-static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i)
+static Mix_Chunk *DecodeVSwapSound(
+	const void *src, const size_t len, const void *data)
+{
+	const CWolfMap *map = data;
+	SDL_AudioCVT cvt;
+	SDL_BuildAudioCVT(
+		&cvt, AUDIO_U8, 1, CWGetAudioSampleRate(map), CDOGS_SND_FMT,
+		CDOGS_SND_CHANNELS, CDOGS_SND_RATE);
+	cvt.len = (int)len;
+	cvt.buf = (Uint8 *)SDL_malloc(cvt.len * cvt.len_mult);
+	memcpy(cvt.buf, src, len);
+	SDL_ConvertAudio(&cvt);
+	Mix_Chunk *chunk = Mix_QuickLoad_RAW(cvt.buf, cvt.len_cvt);
+	if (chunk == NULL)
+	{
+		SDL_free(cvt.buf);
+		return NULL;
+	}
+	// The chunk owns the converted samples, so it can be evicted
+	chunk->allocated = 1;
+	return chunk;
+}
+// Digitised sounds are converted on first play, straight from the VSWAP
+// data which the campaign keeps loaded for as long as its sounds
+static SoundChunk *LoadSoundData(const CWolfMap *map, const int i)
 {
 	const char *data;
 	size_t len;
@@ -922,36 +981,49 @@ static Mix_Chunk *LoadSoundData(const CWolfMap *map, const int i)
 		LOG(LM_MAP, LL_ERROR, "Wolf sound %d has 0 len\n", i);
 		return NULL;
 	}
-	SDL_AudioCVT cvt;
-	SDL_BuildAudioCVT(
-		&cvt, AUDIO_U8, 1, CWGetAudioSampleRate(map), CDOGS_SND_FMT,
-		CDOGS_SND_CHANNELS, CDOGS_SND_RATE);
-	cvt.len = (int)len;
-	cvt.buf = (Uint8 *)SDL_malloc(cvt.len * cvt.len_mult);
-	memcpy(cvt.buf, data, len);
-	SDL_ConvertAudio(&cvt);
-	return Mix_QuickLoad_RAW(cvt.buf, cvt.len_cvt);
+	return SoundChunkNewLazyRef(DecodeVSwapSound, map, data, len);
 }
-static Mix_Chunk *LoadAdlibSoundData(const CWolfMap *map, const int i)
+static Mix_Chunk *DecodeAdlibSound(
+	const void *src, const size_t srcLen, const void *data)
 {
-	char *data;
+	UNUSED(data);
+	char *pcm;
 	size_t len;
-	const int err = CWAudioGetAdlibSound(&map->audio, i, &data, &len);
-	if (err != 0)
+	const int err = CWAudioRenderAdlibSound(src, srcLen, &pcm, &len);
+	if (err != 0 || len == 0)
 	{
-		LOG(LM_MAP, LL_ERROR, "Failed to load adlib wolf sound %d: %d\n", i,
-			err);
+		free(pcm);
 		return NULL;
 	}
-	if (len == 0)
+	// Copy into a buffer the chunk owns, so it is freed on eviction
+	Uint8 *buf = SDL_malloc(len);
+	memcpy(buf, pcm, len);
+	free(pcm);
+	Mix_Chunk *chunk = Mix_QuickLoad_RAW(buf, (Uint32)len);
+	if (chunk == NULL)
 	{
-		LOG(LM_MAP, LL_ERROR, "Wolf sound %d has 0 len\n", i);
+		SDL_free(buf);
+		return NULL;
+	}
+	chunk->allocated = 1;
+	return chunk;
+}
+// Adlib sounds are synthesised on first play
+static SoundChunk *LoadAdlibSoundData(const CWolfMap *map, const int i)
+{
+	const char *data;
+	size_t len;
+	const int err = CWAudioGetAdlibSoundRaw(&map->audio, i, &data, &len);
+	if (err != 0)
+	{
+		LOG(LM_MAP, LL_ERROR, "Failed to load adlib wolf sound %d: %d\n", i,
+			err);
 		return NULL;
 	}
-	return Mix_QuickLoad_RAW((Uint8 *)data, (Uint32)len);
+	return SoundChunkNewLazy(DecodeAdlibSound, NULL, data, len);
 }
 static void AddNormalSound(
-	const SoundDevice *s, const char *name, Mix_Chunk *data)
+	const SoundDevice *s, const char *name, SoundChunk *data)
 {
 	SoundData *sound;
 	CMALLOC(sound, sizeof *sound);
@@ -960,9 +1032,10 @@ static void AddNormalSound(
 	SoundAdd(s->customSounds, name, sound);
 }
 static void AddRandomSound(
-	const SoundDevice *s, const char *name, Mix_Chunk *data)
+	const SoundDevice *s, const char *name, SoundChunk *data)
 {
 	// Strip trailing slash and find the sound
+	SoundChunk *sc = data;
 	SoundData *sound;
 	char nameBuf[CDOGS_PATH_MAX];
 	strcpy(nameBuf, name);
@@ -970,14 +1043,14 @@ static void AddRandomSound(
 	const int err = hashmap_get(s->customSounds, nameBuf, (any_t *)&sound);
 	if (err == MAP_OK && sound->Type == SOUND_RANDOM)
 	{
-		CArrayPushBack(&sound->u.random.sounds, &data);
+		CArrayPushBack(&sound->u.random.sounds, &sc);
 	}
 	else
 	{
 		CCALLOC(sound, sizeof *sound);
 		sound->Type = SOUND_RANDOM;
-		CArrayInit(&sound->u.random.sounds, sizeof(Mix_Chunk *));
-		CArrayPushBack(&sound->u.random.sounds, &data);
+		CArrayInit(&sound->u.random.sounds, sizeof(SoundChunk *));
+		CArrayPushBack(&sound->u.random.sounds, &sc);
 		SoundAdd(s->customSounds, nameBuf, sound);
 	}
 }
@@ -1121,6 +1194,7 @@ static void LoadMission(
 		m.Music.Data.Chunk.Data = msd;
 		m.Music.Data.Chunk.GetData = GetMissionSong;
 		m.Music.Data.Chunk.isMusic = false;
+		m.Music.Data.Chunk.isStream = false;
 		m.Music.Data.Chunk.u.Chunk = NULL;
 
 		MissionStaticInit(&m.u.Static);
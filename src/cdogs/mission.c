@@ -359,6 +359,42 @@ static void SetupWeapons(CArray *to, CArray *from)
 	CArrayCopy(to, from);
 }
 
+static void PreloadWeaponSounds(const WeaponClass *wc)
+{
+	if (wc == NULL)
+	{
+		return;
+	}
+	SoundPreload(&gSoundDevice, wc->SwitchSound);
+	for (int i = 0; i < WeaponClassNumBarrels(wc); i++)
+	{
+		const WeaponClass *barrel = WeaponClassGetBarrel(wc, i);
+		if (barrel == NULL)
+		{
+			continue;
+		}
+		SoundPreload(&gSoundDevice, barrel->u.Normal.Sound);
+		SoundPreload(&gSoundDevice, barrel->u.Normal.ReloadSound);
+	}
+}
+// Decode the sounds of the mission's weapons up front so that the first
+// shots don't stall on loading
+static void PreloadMissionSounds(const Mission *m)
+{
+	CA_FOREACH(const WeaponClass *, wc, m->Weapons)
+	PreloadWeaponSounds(*wc);
+	CA_FOREACH_END()
+	const CharacterStore *s = &gCampaign.Setting.characters;
+	CA_FOREACH(const int, e, m->Enemies)
+	const Character *c = CArrayGet(&s->OtherChars, *e);
+	PreloadWeaponSounds(c->Gun);
+	CA_FOREACH_END()
+	CA_FOREACH(const int, sc, m->SpecialChars)
+	const Character *c = CArrayGet(&s->OtherChars, *sc);
+	PreloadWeaponSounds(c->Gun);
+	CA_FOREACH_END()
+}
+
 void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex)
 {
 	MissionOptionsInit(mo);
@@ -374,6 +410,7 @@ void SetupMission(Mission *m, struct MissionOptions *mo, int missionIndex)
 	SetupObjectives(m);
 	SetupBadguysForMission(m);
 	SetupWeapons(&mo->Weapons, &m->Weapons);
+	PreloadMissionSounds(m);
 }
 void MissionSetupTileClasses(
 	Map *m, PicManager *pm, const MissionTileClasses *mtc)
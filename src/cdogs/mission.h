@@ -218,6 +218,8 @@ struct MissionOptions
 	// Time when players first entered pickup area
 	int pickupTime;
 	MissionState state;
+	// Whether building the map has started, ahead of the mission start
+	bool MapBuildStarted;
 	// Whether the mission has loaded
 	bool HasStarted;
 	// Whether the mission has begun (can complete objectives etc.)
@@ -217,6 +217,14 @@ void MusicPlayChunk(MusicPlayer *mp, const MusicType type, MusicChunk *chunk)
 			chunk->u.Music = NULL;
 			PlayMusic(mp);
 		}
+		else if (chunk->isStream)
+		{
+			mp->type = MUSIC_SRC_STREAM;
+			mp->u.stream = chunk->u.Stream;
+			// The player owns the stream now; reopen it next time
+			memset(&chunk->u.Stream, 0, sizeof chunk->u.Stream);
+			PlayMusic(mp);
+		}
 		else
 		{
 			mp->type = MUSIC_SRC_CHUNK;
@@ -253,6 +261,15 @@ void MusicStop(MusicPlayer *mp)
 		}
 		mp->u.chunk.chunk = NULL;
 		break;
+	case MUSIC_SRC_STREAM:
+		// Unhooking waits for the audio callback, so the stream is unused
+		Mix_HookMusic(NULL, NULL);
+		if (mp->u.stream.Free != NULL)
+		{
+			mp->u.stream.Free(mp->u.stream.Data);
+		}
+		memset(&mp->u.stream, 0, sizeof mp->u.stream);
+		break;
 	}
 }
 
@@ -270,6 +287,9 @@ void MusicPause(MusicPlayer *mp)
 	case MUSIC_SRC_CHUNK:
 		Mix_Pause(mp->u.chunk.channel);
 		break;
+	case MUSIC_SRC_STREAM:
+		Mix_HookMusic(NULL, NULL);
+		break;
 	}
 }
 
@@ -308,6 +328,12 @@ void MusicResume(MusicPlayer *mp)
 	case MUSIC_SRC_CHUNK:
 		Mix_Resume(mp->u.chunk.channel);
 		break;
+	case MUSIC_SRC_STREAM:
+		if (mp->u.stream.Fill != NULL)
+		{
+			Mix_HookMusic(mp->u.stream.Fill, mp->u.stream.Data);
+		}
+		break;
 	}
 }
 
@@ -330,7 +356,14 @@ const char *MusicGetErrorMessage(const MusicPlayer *mp)
 
 void MusicChunkTerminate(MusicChunk *chunk)
 {
-	if (!chunk->isMusic && chunk->u.Chunk)
+	if (chunk->isStream)
+	{
+		if (chunk->u.Stream.Free != NULL)
+		{
+			chunk->u.Stream.Free(chunk->u.Stream.Data);
+		}
+	}
+	else if (!chunk->isMusic && chunk->u.Chunk)
 	{
 		Mix_FreeChunk(chunk->u.Chunk);
 	}
@@ -341,8 +374,16 @@ void MusicChunkTerminate(MusicChunk *chunk)
 void MusicPlayFromChunk(
 	MusicPlayer *mp, const MusicType type, MusicChunk *chunk)
 {
-	if ((chunk->isMusic ? chunk->u.Music == NULL : chunk->u.Chunk == NULL) &&
-		chunk->GetData)
+	bool isLoaded = chunk->u.Chunk != NULL;
+	if (chunk->isMusic)
+	{
+		isLoaded = chunk->u.Music != NULL;
+	}
+	else if (chunk->isStream)
+	{
+		isLoaded = chunk->u.Stream.Fill != NULL;
+	}
+	if (!isLoaded && chunk->GetData)
 	{
 		chunk->isMusic = chunk->GetData(chunk, chunk->Data);
 		// Note: don't free the data; we need to reload it after it is freed in MusicStop
@@ -72,9 +72,19 @@ typedef enum
 {
 	MUSIC_SRC_GENERAL,
 	MUSIC_SRC_DYNAMIC,
-	MUSIC_SRC_CHUNK
+	MUSIC_SRC_CHUNK,
+	MUSIC_SRC_STREAM
 } MusicSourceType;
 
+// Music generated while it plays, through the mixer's music hook
+typedef struct
+{
+	// Called on the audio thread to fill the buffer in the mixer format
+	void (*Fill)(void *, Uint8 *, int);
+	void (*Free)(void *);
+	void *Data;
+} MusicStream;
+
 typedef struct
 {
 	bool isInitialised;
@@ -87,6 +97,7 @@ typedef struct
 			Mix_Chunk *chunk;
 			int channel;
 		} chunk;
+		MusicStream stream;
 	} u;
 	CArray generalTracks[MUSIC_COUNT]; // of Mix_Music *
 	char errorMessage[128];
@@ -97,9 +108,11 @@ typedef struct _MusicChunk
 	void *Data;
 	bool (*GetData)(struct _MusicChunk *, void *);
 	bool isMusic;
+	bool isStream;
 	union {
 		Mix_Chunk *Chunk;
 		Mix_Music *Music;
+		MusicStream Stream;
 	} u;
 } MusicChunk;
 
@@ -59,6 +59,8 @@
 
 CArray gObjs;
 CArray gMobObjs;
+// Objects that need updating each tick, as indices into gObjs
+static CArray sActiveObjs; // of int
 static unsigned int sObjUIDs = 0;
 static unsigned int sMobObjUIDs = 0;
 
@@ -107,6 +109,7 @@ void DamageObject(const NThingDamage d)
 	}
 
 	o->Health -= d.Power;
+	ObjWake(o);
 
 	// Destroying objects and all the wonderful things that happen
 	if (o->Health <= 0)
@@ -440,6 +443,7 @@ void ObjsInit(void)
 {
 	CArrayInit(&gObjs, sizeof(TObject));
 	CArrayReserve(&gObjs, 1024);
+	CArrayInit(&sActiveObjs, sizeof(int));
 	sObjUIDs = 0;
 }
 void ObjsTerminate(void)
@@ -451,6 +455,7 @@ void ObjsTerminate(void)
 	}
 	CA_FOREACH_END()
 	CArrayTerminate(&gObjs);
+	CArrayTerminate(&sActiveObjs);
 }
 int ObjsGetNextUID(void)
 {
@@ -520,6 +525,7 @@ void ObjAdd(const NMapObjectAdd amo)
 			&gParticleClasses, o->Class->DamageSmoke.ParticleClass),
 		svec2_zero(), -0.05f, 0.05f, 3, 3, 0, 0, o->Class->DamageSmoke.Ticks);
 	o->isInUse = true;
+	ObjWake(o);
 	LOG(LM_MAIN, LL_DEBUG,
 		"added object uid(%d) class(%s) health(%d) pos(%d, %d)", (int)amo.UID,
 		amo.MapObjectClass, amo.Health, (int)amo.Pos.x, (int)amo.Pos.y);
@@ -536,6 +542,28 @@ void ObjDestroy(TObject *o)
 	CASSERT(o->isInUse, "Destroying in-use object");
 	MapRemoveThing(&gMap, &o->thing);
 	o->isInUse = false;
+	if (o->isAwake)
+	{
+		const int id = o->thing.id;
+		CA_FOREACH(const int, idx, sActiveObjs)
+		if (*idx == id)
+		{
+			CArrayDelete(&sActiveObjs, _ca_index);
+			break;
+		}
+		CA_FOREACH_END()
+		o->isAwake = false;
+	}
+}
+
+void ObjWake(TObject *o)
+{
+	if (o == NULL || !o->isInUse || o->isAwake)
+	{
+		return;
+	}
+	o->isAwake = true;
+	CArrayPushBack(&sActiveObjs, &o->thing.id);
 }
 
 bool ObjIsDangerous(const TObject *o)
@@ -544,21 +572,64 @@ bool ObjIsDangerous(const TObject *o)
 	return o->Class->DestroyGuns.size > 0;
 }
 
+static bool ObjIsDamagedSmoking(const TObject *o)
+{
+	return o->Class->DamageSmoke.HealthThreshold >= 0 &&
+		   o->Health <=
+			   o->Class->Health * o->Class->DamageSmoke.HealthThreshold;
+}
+// Whether the object has anything to do in its update
+static bool ObjNeedsUpdate(const TObject *o)
+{
+	if (!o->isInUse)
+	{
+		return false;
+	}
+	if (o->thing.SoundLock > 0 || !svec2_is_zero(o->thing.drawShake) ||
+		o->thing.CPic.Type == PICTYPE_ANIMATED ||
+		o->thing.CPic.Type == PICTYPE_ANIMATED_RANDOM)
+	{
+		return true;
+	}
+	switch (o->Class->Type)
+	{
+	case MAP_OBJECT_TYPE_NORMAL:
+		return ObjIsDamagedSmoking(o);
+	case MAP_OBJECT_TYPE_PICKUP_SPAWNER:
+	case MAP_OBJECT_TYPE_ACTOR_SPAWNER:
+		return !gCampaign.IsClient && o->counter != -1;
+	default:
+		return false;
+	}
+}
+static void ObjUpdate(TObject *obj, const int ticks);
 void UpdateObjects(const int ticks)
 {
-	CA_FOREACH(TObject, obj, gObjs)
-	if (!obj->isInUse)
+	// Only update awake objects; put the rest back to sleep
+	int n = 0;
+	for (int i = 0; i < (int)sActiveObjs.size; i++)
 	{
-		continue;
+		const int *idx = CArrayGet(&sActiveObjs, i);
+		TObject *obj = CArrayGet(&gObjs, *idx);
+		if (!ObjNeedsUpdate(obj))
+		{
+			obj->isAwake = false;
+			continue;
+		}
+		CArraySet(&sActiveObjs, n, idx);
+		n++;
+		ObjUpdate(obj, ticks);
 	}
+	CArrayResize(&sActiveObjs, n, NULL);
+}
+static void ObjUpdate(TObject *obj, const int ticks)
+{
 	ThingUpdate(&obj->thing, ticks);
 	switch (obj->Class->Type)
 	{
 	case MAP_OBJECT_TYPE_NORMAL:
 		// Emit smoke when damaged
-		if (obj->Class->DamageSmoke.HealthThreshold >= 0 &&
-			obj->Health <=
-				obj->Class->Health * obj->Class->DamageSmoke.HealthThreshold)
+		if (ObjIsDamagedSmoking(obj))
 		{
 			AddParticle ap;
 			memset(&ap, 0, sizeof ap);
@@ -627,7 +698,6 @@ void UpdateObjects(const int ticks)
 		// Do nothing
 		break;
 	}
-	CA_FOREACH_END()
 }
 
 TObject *ObjGetByUID(const int uid)
@@ -70,6 +70,7 @@ typedef struct
 	Thing thing;
 	Emitter damageSmoke;
 	bool isInUse;
+	bool isAwake; // in the active list, updated every tick
 } TObject;
 
 typedef struct MobileObject
@@ -86,6 +87,10 @@ typedef struct MobileObject
 	Thing thing;
 	Emitter trail;
 	const WeaponClass *weapon; // Weapon that fired this
+	// Homing bullets stick to a target and only search again periodically
+	int targetId;
+	int targetUID;
+	int targetTicks;
 	bool isInUse;
 } TMobileObject;
 typedef int (*MobObjUpdateFunc)(TMobileObject *, int);
@@ -108,6 +113,9 @@ int ObjsGetNextUID(void);
 void ObjAdd(const NMapObjectAdd amo);
 void ObjRemove(const NMapObjectRemove mor);
 void ObjDestroy(TObject *o);
+// Add to the active list so that the object is updated; it goes back to
+// sleep once it has nothing to do
+void ObjWake(TObject *o);
 
 // Check if this object is dangerous; i.e. on destruction will explode
 bool ObjIsDangerous(const TObject *o);
@@ -56,8 +56,7 @@ Uint32 ColorToPixel(
 		((Uint32)color.a << aShift);
 }
 
-// Get the true pixel size of the pic
-static struct vec2i PicPixelSize(const Pic *p)
+struct vec2i PicPixelSize(const Pic *p)
 {
 	if (p->isHD)
 	{
@@ -116,14 +115,10 @@ void PicLoad(
 bail:
 	PicFree(p);
 }
-bool PicTryMakeTex(Pic *p)
+// Destroy the pic's own texture; shared textures are owned elsewhere
+static void PicDestroyTex(Pic *p)
 {
-	CASSERT(!PicIsNone(p), "cannot make tex of none pic");
-	if (textureDebugger == NULL)
-	{
-		textureDebugger = hashmap_new();
-	}
-	if (p->Tex != NULL)
+	if (p->Tex != NULL && !p->texShared)
 	{
 		LOG(LM_GFX, LL_TRACE, "destroying texture %p data(%p)", p->Tex, p->Data);
 		SDL_DestroyTexture(p->Tex);
@@ -149,6 +144,18 @@ bool PicTryMakeTex(Pic *p)
 			}
 		}
 	}
+	p->Tex = NULL;
+	p->texShared = false;
+	p->texPos = svec2i_zero();
+}
+bool PicTryMakeTex(Pic *p)
+{
+	CASSERT(!PicIsNone(p), "cannot make tex of none pic");
+	if (textureDebugger == NULL)
+	{
+		textureDebugger = hashmap_new();
+	}
+	PicDestroyTex(p);
 	const struct vec2i size = PicPixelSize(p);
 	p->Tex = TextureCreate(
 		gGraphicsDevice.gameWindow.renderer, SDL_TEXTUREACCESS_STATIC,
@@ -197,38 +204,23 @@ Pic PicCopy(const Pic *src)
 	CMALLOC(p.Data, size);
 	memcpy(p.Data, src->Data, size);
 	p.Tex = NULL;
+	p.texShared = false;
+	p.texPos = svec2i_zero();
 	p.isHD = src->isHD;
 	return p;
 }
 
+void PicSetSharedTex(Pic *p, SDL_Texture *t, const struct vec2i pos)
+{
+	PicDestroyTex(p);
+	p->Tex = t;
+	p->texShared = true;
+	p->texPos = pos;
+}
+
 void PicFree(Pic *pic)
 {
-	if (pic->Tex != NULL)
-	{
-		LOG(LM_GFX, LL_TRACE, "freeing texture %p data(%p)", pic->Tex, pic->Data);
-		SDL_DestroyTexture(pic->Tex);
-		if (LL_TRACE >= LogModuleGetLevel(LM_GFX))
-		{
-			char key[32];
-			sprintf(key, "%p", pic->Tex);
-			if (hashmap_get(textureDebugger, key, NULL) == MAP_OK)
-			{
-				if (hashmap_remove(textureDebugger, key) != MAP_OK)
-				{
-					LOG(LM_GFX, LL_TRACE, "Error: cannot remove tex from debugger");
-				}
-				else
-				{
-					LOG(LM_GFX, LL_TRACE, "Texture count: %d",
-						hashmap_length(textureDebugger));
-				}
-			}
-			else
-			{
-				LOG(LM_GFX, LL_TRACE, "Error: destroying unknown texture");
-			}
-		}
-	}
+	PicDestroyTex(pic);
 	pic->size = svec2i_zero();
 	CFREE(pic->Data);
 	pic->Data = NULL;
@@ -351,5 +343,15 @@ void PicRender(
 		dest.Size.y = (mint_t)MROUND(src.Size.y * destScale.y);
 	}
 	const double angle = ToDegrees(radians);
-	TextureRender(p->Tex, r, src, dest, mask, angle, flip);
+	TextureRender(
+		p->Tex, r, PicGetTexRect(p, src), dest, mask, angle, flip);
+}
+
+Rect2i PicGetTexRect(const Pic *p, const Rect2i src)
+{
+	if (Rect2iIsZero(src))
+	{
+		return Rect2iNew(p->texPos, PicPixelSize(p));
+	}
+	return Rect2iNew(svec2i_add(src.Pos, p->texPos), src.Size);
 }
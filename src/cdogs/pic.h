@@ -36,6 +36,9 @@ typedef struct
 	bool isHD;
 	Uint32 *Data;
 	SDL_Texture *Tex;
+	// If set, Tex is a shared atlas page and the pic is at texPos within it
+	bool texShared;
+	struct vec2i texPos;
 } Pic;
 
 color_t PixelToColor(
@@ -51,9 +54,16 @@ void PicLoad(
 	Pic *p, const struct vec2i size, const struct vec2i offset,
 	const SDL_Surface *image, const bool isHD);
 bool PicTryMakeTex(Pic *p);
+// Replace the pic's own texture with a region of a shared texture
+void PicSetSharedTex(Pic *p, SDL_Texture *t, const struct vec2i pos);
 Pic PicCopy(const Pic *src);
 void PicFree(Pic *pic);
 bool PicIsNone(const Pic *pic);
+// Get the true pixel size of the pic
+struct vec2i PicPixelSize(const Pic *p);
+// Convert a source rect within the pic to one within its texture
+// A zero rect means the whole pic
+Rect2i PicGetTexRect(const Pic *p, const Rect2i src);
 
 // Detect unused edges and update size and offset to fit
 void PicTrim(Pic *pic, const bool xTrim, const bool yTrim);
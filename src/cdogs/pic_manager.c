@@ -34,8 +34,20 @@
 
 #define GRAPHICS_DIR "graphics"
 #define GRAPHICS_HD_DIR "graphics_hd"
+// Limits for colour-masked character sprites
+#define MASKED_CHAR_SPRITES_MAX 256
+#define MASKED_ATLAS_PAGE_SIZE 1024
+#define MASKED_ATLAS_MAX_PAGES 4
+
+typedef struct
+{
+	NamedSprites sprites;
+	uint64_t lastUsed;
+} MaskedCharSprites;
 
 PicManager gPicManager;
+// Incremented whenever pics are added or removed, to invalidate PicHandles
+static int sPicsGeneration = 0;
 
 void PicManagerInit(PicManager *pm)
 {
@@ -53,6 +65,12 @@ void PicManagerInit(PicManager *pm)
 	CArrayInit(&pm->exitStyleNames, sizeof(char *));
 	CArrayInit(&pm->doorStyleNames, sizeof(char *));
 	CArrayInit(&pm->keyStyleNames, sizeof(char *));
+	TextureAtlasInit(&pm->atlas);
+	TextureAtlasInit(&pm->customAtlas);
+	pm->maskedCharSprites = hashmap_new();
+	TextureAtlasInit(&pm->maskedAtlas);
+	pm->maskedAtlas.PageSize =
+		svec2i(MASKED_ATLAS_PAGE_SIZE, MASKED_ATLAS_PAGE_SIZE);
 }
 
 static NamedPic *AddNamedPic(map_t pics, const char *name, const Pic *p);
@@ -244,6 +262,7 @@ void PicManagerLoadDir(
 
 bail:
 	tinydir_close(&dir);
+	sPicsGeneration++;
 }
 void PicManagerLoad(PicManager *pm)
 {
@@ -252,6 +271,66 @@ void PicManagerLoad(PicManager *pm)
 	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites, false);
 	GetDataFilePath(buf, GRAPHICS_HD_DIR);
 	PicManagerLoadDir(pm, buf, NULL, pm->pics, pm->sprites, true);
+	PicManagerPackAtlas(pm);
+}
+
+typedef struct
+{
+	CArray pics;	// of Pic *
+	bool skipChars;
+} PackData;
+static int AddPicToPack(any_t data, any_t item);
+static int AddSpritesToPack(any_t data, any_t item);
+static void PackAtlas(
+	TextureAtlas *a, map_t pics, map_t sprites, const bool skipChars)
+{
+	PackData pd;
+	CArrayInit(&pd.pics, sizeof(Pic *));
+	pd.skipChars = skipChars;
+	hashmap_iterate(pics, AddPicToPack, &pd);
+	hashmap_iterate(sprites, AddSpritesToPack, &pd);
+	TextureAtlasAddPics(a, &pd.pics);
+	LOG(LM_GFX, LL_DEBUG, "packed %d pics into %d atlas pages",
+		(int)pd.pics.size, (int)a->Pages.size);
+	CArrayTerminate(&pd.pics);
+}
+static bool ShouldPack(const PackData *pd, const Pic *p, const char *name)
+{
+	if (p->Tex == NULL || p->texShared)
+	{
+		return false;
+	}
+	// Base character sprites are never drawn directly, only their
+	// colour-masked copies, which are packed when they are generated
+	return !pd->skipChars || strncmp(name, "chars/", strlen("chars/")) != 0;
+}
+static int AddPicToPack(any_t data, any_t item)
+{
+	PackData *pd = data;
+	NamedPic *n = item;
+	if (ShouldPack(pd, &n->pic, n->name))
+	{
+		Pic *p = &n->pic;
+		CArrayPushBack(&pd->pics, &p);
+	}
+	return MAP_OK;
+}
+static int AddSpritesToPack(any_t data, any_t item)
+{
+	PackData *pd = data;
+	NamedSprites *n = item;
+	CA_FOREACH(Pic, p, n->pics)
+	if (ShouldPack(pd, p, n->name))
+	{
+		CArrayPushBack(&pd->pics, &p);
+	}
+	CA_FOREACH_END()
+	return MAP_OK;
+}
+void PicManagerPackAtlas(PicManager *pm)
+{
+	PackAtlas(&pm->atlas, pm->pics, pm->sprites, true);
+	PackAtlas(&pm->customAtlas, pm->customPics, pm->customSprites, false);
 }
 
 static void FindStylePics(
@@ -269,6 +348,7 @@ static int MaybeAddKeyPicName(any_t data, any_t item);
 static int MaybeAddDoorPicName(any_t data, any_t item);
 static void AfterAdd(PicManager *pm)
 {
+	sPicsGeneration++;
 	FindStyleSprites(
 		pm, &pm->headPartNames[HEAD_PART_HAIR], MaybeAddHairSpriteName);
 	FindStyleSprites(
@@ -450,10 +530,14 @@ static int MaybeAddTilePicName(any_t data, any_t item)
 // Need to free the pics and the memory since hashmap stores on heap
 static void NamedPicDestroy(any_t data);
 static void NamedSpritesDestroy(any_t data);
+static void MaskedCharSpritesClear(PicManager *pm);
 void PicManagerClearCustom(PicManager *pm)
 {
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
+	TextureAtlasClear(&pm->customAtlas);
+	// Masked sprites may have been made from custom sprites
+	MaskedCharSpritesClear(pm);
 	AfterAdd(pm);
 }
 static void PicManagerUnload(PicManager *pm)
@@ -462,6 +546,9 @@ static void PicManagerUnload(PicManager *pm)
 	hashmap_clear(pm->sprites, NamedSpritesDestroy);
 	hashmap_clear(pm->customPics, NamedPicDestroy);
 	hashmap_clear(pm->customSprites, NamedSpritesDestroy);
+	TextureAtlasClear(&pm->atlas);
+	TextureAtlasClear(&pm->customAtlas);
+	MaskedCharSpritesClear(pm);
 	AfterAdd(pm);
 }
 static void StyleNamesDestroy(CArray *a)
@@ -483,6 +570,9 @@ void PicManagerTerminate(PicManager *pm)
 	StyleNamesDestroy(&pm->exitStyleNames);
 	StyleNamesDestroy(&pm->doorStyleNames);
 	StyleNamesDestroy(&pm->keyStyleNames);
+	TextureAtlasTerminate(&pm->atlas);
+	TextureAtlasTerminate(&pm->customAtlas);
+	TextureAtlasTerminate(&pm->maskedAtlas);
 }
 static void NamedPicDestroy(any_t data)
 {
@@ -496,6 +586,18 @@ static void NamedSpritesDestroy(any_t data)
 	NamedSpritesFree(n);
 	CFREE(n);
 }
+static void MaskedCharSpritesDestroy(any_t data)
+{
+	MaskedCharSprites *m = data;
+	NamedSpritesFree(&m->sprites);
+	CFREE(m);
+}
+static void MaskedCharSpritesClear(PicManager *pm)
+{
+	hashmap_clear(pm->maskedCharSprites, MaskedCharSpritesDestroy);
+	TextureAtlasClear(&pm->maskedAtlas);
+	pm->maskedGeneration++;
+}
 static int ReloadTexture(any_t data, any_t item);
 static int ReloadSpriteTexture(any_t data, any_t item);
 void PicManagerReloadTextures(PicManager *pm)
@@ -504,6 +606,12 @@ void PicManagerReloadTextures(PicManager *pm)
 	hashmap_iterate(pm->customPics, ReloadTexture, NULL);
 	hashmap_iterate(pm->sprites, ReloadSpriteTexture, NULL);
 	hashmap_iterate(pm->customSprites, ReloadSpriteTexture, NULL);
+	// The atlas pages belonged to the old renderer
+	TextureAtlasClear(&pm->atlas);
+	TextureAtlasClear(&pm->customAtlas);
+	PicManagerPackAtlas(pm);
+	// Masked sprites are cheap to regenerate on demand
+	MaskedCharSpritesClear(pm);
 }
 static int ReloadTexture(any_t data, any_t item)
 {
@@ -552,6 +660,15 @@ Pic *PicManagerGetPic(const PicManager *pm, const char *name)
 		return &n->pic;
 	return NULL;
 }
+Pic *PicHandleGet(PicHandle *h)
+{
+	if (h->generation != sPicsGeneration)
+	{
+		h->pic = PicManagerGetPic(&gPicManager, h->Name);
+		h->generation = sPicsGeneration;
+	}
+	return h->pic;
+}
 const NamedSprites *PicManagerGetSprites(
 	const PicManager *pm, const char *name)
 {
@@ -627,7 +744,7 @@ static void PicManagerGenerateMaskedPic(
 		p.Data[i] = COLOR2PIXEL(c);
 		// TODO: more channels
 	}
-	if (!PicTryMakeTex(&p))
+	if (!TextureAtlasAdd(&pm->customAtlas, &p) && !PicTryMakeTex(&p))
 	{
 		p.Tex = NULL;
 	}
@@ -644,23 +761,26 @@ void PicManagerGenerateMaskedStylePic(
 	PicManagerGenerateMaskedPic(pm, buf, mask, maskAlt, noAltMask);
 }
 
-const NamedSprites *PicManagerGetCharSprites(
+NamedSprites *PicManagerGetCharSprites(
 	PicManager *pm, const char *name, const CharColors *colors)
 {
 	char buf[CDOGS_PATH_MAX];
 	CharColorsGetMaskedName(buf, name, colors);
 	// Get or generate masked sprites
-	const NamedSprites *ns = PicManagerGetSprites(&gPicManager, buf);
-	if (ns != NULL)
+	MaskedCharSprites *m;
+	if (hashmap_get(pm->maskedCharSprites, buf, (any_t *)&m) == MAP_OK)
 	{
-		return ns;
+		m->lastUsed = pm->maskedTick++;
+		return &m->sprites;
 	}
 	const NamedSprites *ons = PicManagerGetSprites(pm, name);
 	if (ons == NULL)
 	{
 		return NULL;
 	}
-	NamedSprites *nsp = AddNamedSprites(pm->customSprites, buf);
+	CMALLOC(m, sizeof *m);
+	NamedSpritesInit(&m->sprites, buf);
+	m->lastUsed = pm->maskedTick++;
 	CA_FOREACH(Pic, op, ons->pics)
 	Pic p = PicCopy(op);
 	p.Tex = NULL;
@@ -674,14 +794,161 @@ const NamedSprites *PicManagerGetCharSprites(
 		p.Data[i] =
 			COLOR2PIXEL(ColorMult(c, CharColorsGetChannelMask(colors, c.a)));
 	}
-	if (!PicTryMakeTex(&p))
+	if (!TextureAtlasAdd(&pm->maskedAtlas, &p) && !PicTryMakeTex(&p))
 	{
 		p.Tex = NULL;
 	}
-	CArrayPushBack(&nsp->pics, &p);
+	CArrayPushBack(&m->sprites.pics, &p);
 	CA_FOREACH_END()
-	AfterAdd(pm);
-	return nsp;
+	const int error = hashmap_put(pm->maskedCharSprites, buf, m);
+	if (error != MAP_OK)
+	{
+		LOG(LM_MAIN, LL_ERROR, "failed to add masked sprites %s: %d", buf,
+			error);
+		MaskedCharSpritesDestroy(m);
+		return NULL;
+	}
+	return &m->sprites;
+}
+
+void PicManagerTouchCharSprites(PicManager *pm, NamedSprites *ns)
+{
+	if (ns == NULL)
+	{
+		return;
+	}
+	// The sprites are the first member of MaskedCharSprites
+	MaskedCharSprites *m = (MaskedCharSprites *)ns;
+	m->lastUsed = pm->maskedTick++;
+}
+
+static int AddMaskedCharSprites(any_t data, any_t item);
+static int CompareLastUsed(const void *v1, const void *v2);
+static const SDL_Texture *LeastRecentlyUsedPage(
+	const PicManager *pm, const CArray *all, const uint64_t frameStart);
+static bool MaskedCharSpritesUsesPage(
+	const MaskedCharSprites *m, const SDL_Texture *page);
+static void MaskedCharSpritesRemove(PicManager *pm, MaskedCharSprites *m);
+void PicManagerTrimMaskedSprites(PicManager *pm)
+{
+	const uint64_t frameStart = pm->maskedTrimTick;
+	pm->maskedTrimTick = pm->maskedTick;
+	if (pm->maskedAtlas.Pages.size <= MASKED_ATLAS_MAX_PAGES &&
+		hashmap_length(pm->maskedCharSprites) <= MASKED_CHAR_SPRITES_MAX)
+	{
+		return;
+	}
+	// of MaskedCharSprites *, least recently used first; evicted ones are
+	// set to NULL
+	CArray all;
+	CArrayInit(&all, sizeof(MaskedCharSprites *));
+	hashmap_iterate(pm->maskedCharSprites, AddMaskedCharSprites, &all);
+	qsort(all.data, all.size, all.elemSize, CompareLastUsed);
+	bool evicted = false;
+
+	// Atlas space can't be reclaimed piecemeal, so evict whole pages, along
+	// with all the sprites that are on them
+	while (pm->maskedAtlas.Pages.size > MASKED_ATLAS_MAX_PAGES)
+	{
+		const SDL_Texture *page = LeastRecentlyUsedPage(pm, &all, frameStart);
+		if (page == NULL)
+		{
+			// Everything is in use; go over budget rather than thrash
+			break;
+		}
+		CA_FOREACH(MaskedCharSprites *, m, all)
+		if (*m != NULL && MaskedCharSpritesUsesPage(*m, page))
+		{
+			MaskedCharSpritesRemove(pm, *m);
+			*m = NULL;
+		}
+		CA_FOREACH_END()
+		TextureAtlasRemovePage(&pm->maskedAtlas, page);
+		evicted = true;
+	}
+
+	int excess =
+		hashmap_length(pm->maskedCharSprites) - MASKED_CHAR_SPRITES_MAX;
+	CA_FOREACH(MaskedCharSprites *, m, all)
+	if (excess <= 0 || (*m != NULL && (*m)->lastUsed >= frameStart))
+	{
+		break;
+	}
+	if (*m != NULL)
+	{
+		MaskedCharSpritesRemove(pm, *m);
+		excess--;
+		evicted = true;
+	}
+	CA_FOREACH_END()
+
+	CArrayTerminate(&all);
+	if (evicted)
+	{
+		pm->maskedGeneration++;
+	}
+}
+static int AddMaskedCharSprites(any_t data, any_t item)
+{
+	CArray *all = data;
+	CArrayPushBack(all, &item);
+	return MAP_OK;
+}
+static int CompareLastUsed(const void *v1, const void *v2)
+{
+	const MaskedCharSprites *const *m1 = v1;
+	const MaskedCharSprites *const *m2 = v2;
+	if ((*m1)->lastUsed != (*m2)->lastUsed)
+	{
+		return (*m1)->lastUsed < (*m2)->lastUsed ? -1 : 1;
+	}
+	return 0;
+}
+static const SDL_Texture *LeastRecentlyUsedPage(
+	const PicManager *pm, const CArray *all, const uint64_t frameStart)
+{
+	// A page was last used when any sprite on it was; the page being packed
+	// into is never evicted
+	const TextureAtlas *a = &pm->maskedAtlas;
+	const SDL_Texture *lru = NULL;
+	uint64_t lruLastUsed = 0;
+	for (int i = 0; i < (int)a->Pages.size - 1; i++)
+	{
+		const SDL_Texture *page = *(SDL_Texture **)CArrayGet(&a->Pages, i);
+		uint64_t lastUsed = 0;
+		CA_FOREACH(const MaskedCharSprites *, m, *all)
+		if (*m != NULL && MaskedCharSpritesUsesPage(*m, page))
+		{
+			lastUsed = MAX(lastUsed, (*m)->lastUsed);
+		}
+		CA_FOREACH_END()
+		if (lastUsed >= frameStart)
+		{
+			continue;
+		}
+		if (lru == NULL || lastUsed < lruLastUsed)
+		{
+			lru = page;
+			lruLastUsed = lastUsed;
+		}
+	}
+	return lru;
+}
+static bool MaskedCharSpritesUsesPage(
+	const MaskedCharSprites *m, const SDL_Texture *page)
+{
+	CA_FOREACH(const Pic, p, m->sprites.pics)
+	if (p->texShared && p->Tex == page)
+	{
+		return true;
+	}
+	CA_FOREACH_END()
+	return false;
+}
+static void MaskedCharSpritesRemove(PicManager *pm, MaskedCharSprites *m)
+{
+	hashmap_remove(pm->maskedCharSprites, m->sprites.name);
+	MaskedCharSpritesDestroy(m);
 }
 
 static void GetMaskedName(
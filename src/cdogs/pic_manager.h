@@ -30,6 +30,7 @@
 #include "blit.h"
 #include "c_hashmap/hashmap.h"
 #include "cpic.h"
+#include "texture_atlas.h"
 
 typedef struct
 {
@@ -37,6 +38,20 @@ typedef struct
 	map_t sprites;	// of NamedSprites
 	map_t customPics;	// of NamedPic
 	map_t customSprites;	// of NamedSprites
+	TextureAtlas atlas;	// for pics and sprites
+	TextureAtlas customAtlas;	// for custom pics and sprites
+
+	// Colour-masked character sprites, generated on demand and evicted
+	// when least recently used, so memory stays bounded no matter how many
+	// colour combinations are used
+	map_t maskedCharSprites;	// of MaskedCharSprites
+	TextureAtlas maskedAtlas;
+	uint64_t maskedTick;
+	// maskedTick at the last trim; sprites used since then are not evicted
+	uint64_t maskedTrimTick;
+	// Incremented whenever masked character sprites are evicted; pointers
+	// to them obtained before then are no longer valid
+	int maskedGeneration;
 
 	CArray headPartNames[HEAD_PART_COUNT];	// of char *
 	CArray wallStyleNames;	// of char *
@@ -56,6 +71,8 @@ void PicManagerLoadDir(
 void PicManagerClearCustom(PicManager *pm);
 void PicManagerTerminate(PicManager *pm);
 void PicManagerReloadTextures(PicManager *pm);
+// Pack loaded pics and sprites into the atlases
+void PicManagerPackAtlas(PicManager *pm);
 
 // Note: return ptr to NamedPic so we can store that instead of the name
 NamedPic *PicManagerGetNamedPic(const PicManager *pm, const char *name);
@@ -63,6 +80,19 @@ Pic *PicManagerGetPic(const PicManager *pm, const char *name);
 const NamedSprites *PicManagerGetSprites(
 	const PicManager *pm, const char *name);
 
+// Handle to a pic that is looked up by name once, and again only after pics
+// have been added or removed. Use for pics drawn every frame, e.g.
+// static PicHandle shadow = PIC_HANDLE("particles/shadow");
+// const Pic *pic = PicHandleGet(&shadow);
+typedef struct
+{
+	const char *Name;
+	Pic *pic;
+	int generation;
+} PicHandle;
+#define PIC_HANDLE(_name) {_name, NULL, -1}
+Pic *PicHandleGet(PicHandle *h);
+
 // Get a masked pic for the styled tiles: walls, floors, rooms
 // Simply calls GetMaskedPic but the name contains the relevant
 // style/type names
@@ -75,8 +105,17 @@ void PicManagerGenerateMaskedStylePic(
 	PicManager *pm, const char *name, const char *style, const char *type,
 	const color_t mask, const color_t maskAlt, const bool noAltMask);
 // Get masked character pics
-const NamedSprites *PicManagerGetCharSprites(
+// Note: the result is valid until the next PicManagerTrimMaskedSprites.
+// It is not const so that callers that keep it can touch it.
+NamedSprites *PicManagerGetCharSprites(
 	PicManager *pm, const char *name, const CharColors *colors);
+// Mark masked character sprites as used, for callers that keep the result
+// of PicManagerGetCharSprites instead of looking it up again
+void PicManagerTouchCharSprites(PicManager *pm, NamedSprites *ns);
+// Evict least recently used masked character sprites, and atlas pages if
+// there are too many; sprites used since the last trim are kept
+// Call this once per frame, when no masked pics are being held
+void PicManagerTrimMaskedSprites(PicManager *pm);
 
 int PicManagerGetWallStyleIndex(PicManager *pm, const char *style);
 int PicManagerGetTileStyleIndex(PicManager *pm, const char *style);
@@ -95,7 +95,23 @@ int OpenAudio(int frequency, Uint16 format, int channels, int chunkSize)
 	return 0;
 }
 
-static Mix_Chunk *LoadSound(const char *path);
+// Budget for decoded sound file PCM data
+#define SOUND_RESIDENT_BYTES_MAX (24 * 1024 * 1024)
+// Identical sounds started within this time and radius are merged into a
+// single, louder voice
+#define SOUND_MERGE_MS 50
+#define SOUND_MERGE_RADIUS 32
+#define SOUND_MERGE_BOOST 24
+// Max simultaneous voices of the same sound
+#define SOUND_INSTANCES_MAX 4
+
+// Incremented whenever sounds are added or cleared, to rebuild the ID index
+static int sSoundsGeneration = 0;
+// of SoundIdEntry, open addressing table indexed by ID
+static CArray sSoundIds;
+static int sSoundIdsGeneration = -1;
+
+static SoundChunk *SoundChunkNewFile(const char *path);
 static void SoundLoad(map_t sounds, const char *name, const char *path)
 {
 	// If the sound basename is a number, it is part of a group of random
@@ -125,7 +141,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 		SoundData *sound;
 		CCALLOC(sound, sizeof *sound);
 		sound->Type = SOUND_RANDOM;
-		CArrayInit(&sound->u.random.sounds, sizeof(Mix_Chunk *));
+		CArrayInit(&sound->u.random.sounds, sizeof(SoundChunk *));
 		// Remove "0.<ext>" from path
 		const char *ext = StrGetFileExt(path);
 		const int len = (int)(ext - path - 2);
@@ -137,7 +153,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 		{
 			char buf[CDOGS_PATH_MAX];
 			sprintf(buf, fmt, i);
-			Mix_Chunk *data = LoadSound(buf);
+			SoundChunk *data = SoundChunkNewFile(buf);
 			if (data == NULL)
 				break;
 			CArrayPushBack(&sound->u.random.sounds, &data);
@@ -148,7 +164,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 	}
 	else
 	{
-		Mix_Chunk *data = LoadSound(path);
+		SoundChunk *data = SoundChunkNewFile(path);
 		if (data != NULL)
 		{
 			SoundData *sound;
@@ -159,7 +175,7 @@ static void SoundLoad(map_t sounds, const char *name, const char *path)
 		}
 	}
 }
-static Mix_Chunk *LoadSound(const char *path)
+static SoundChunk *SoundChunkNewFile(const char *path)
 {
 	// Only load sounds from known extensions
 	const char *ext = strrchr(path, '.');
@@ -170,12 +186,209 @@ static Mix_Chunk *LoadSound(const char *path)
 	{
 		return NULL;
 	}
-	LOG(LM_MAIN, LL_TRACE, "loading sound file %s", path);
-	return Mix_LoadWAV(path);
+	// Only register the file here; it is decoded on first play
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		return NULL;
+	}
+	SoundChunk *sc;
+	CCALLOC(sc, sizeof *sc);
+	CSTRDUP(sc->path, path);
+	sc->refCount = 1;
+	return sc;
+}
+SoundChunk *SoundChunkNew(Mix_Chunk *data)
+{
+	if (data == NULL)
+	{
+		return NULL;
+	}
+	SoundChunk *sc;
+	CCALLOC(sc, sizeof *sc);
+	sc->loaded = data;
+	sc->chunk = *data;
+	sc->refCount = 1;
+	return sc;
+}
+SoundChunk *SoundChunkNewLazy(
+	Mix_Chunk *(*decode)(const void *, const size_t, const void *),
+	const void *decodeData, const void *src, const size_t srcLen)
+{
+	void *srcCopy;
+	CMALLOC(srcCopy, srcLen);
+	memcpy(srcCopy, src, srcLen);
+	SoundChunk *sc = SoundChunkNewLazyRef(decode, decodeData, srcCopy, srcLen);
+	sc->ownedSrc = srcCopy;
+	return sc;
+}
+SoundChunk *SoundChunkNewLazyRef(
+	Mix_Chunk *(*decode)(const void *, const size_t, const void *),
+	const void *decodeData, const void *src, const size_t srcLen)
+{
+	SoundChunk *sc;
+	CCALLOC(sc, sizeof *sc);
+	sc->decode = decode;
+	sc->decodeData = decodeData;
+	sc->src = src;
+	sc->srcLen = srcLen;
+	sc->refCount = 1;
+	return sc;
+}
+SoundChunk *SoundChunkRef(SoundChunk *sc)
+{
+	if (sc != NULL)
+	{
+		sc->refCount++;
+	}
+	return sc;
+}
+static void SoundChunkFreeSrc(SoundChunk *sc)
+{
+	CFREE(sc->ownedSrc);
+	sc->ownedSrc = NULL;
+	sc->src = NULL;
+}
+static bool SoundChunkIsEvictable(const SoundChunk *sc)
+{
+	return sc->path != NULL || sc->src != NULL;
+}
+static bool SoundChunkIsPlaying(const SoundDevice *device, SoundChunk *sc)
+{
+	for (int i = 0; i < device->channels; i++)
+	{
+		if (Mix_Playing(i) && Mix_GetChunk(i) == &sc->chunk)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+static void SoundChunkUnload(SoundDevice *device, SoundChunk *sc)
+{
+	if (sc->loaded == NULL)
+	{
+		return;
+	}
+	if (device->isInitialised)
+	{
+		for (int i = 0; i < device->channels; i++)
+		{
+			if (Mix_GetChunk(i) == &sc->chunk)
+			{
+				Mix_HaltChannel(i);
+			}
+		}
+	}
+	if (SoundChunkIsEvictable(sc))
+	{
+		CA_FOREACH(SoundChunk *, r, device->resident)
+		if (*r == sc)
+		{
+			CArrayDelete(&device->resident, _ca_index);
+			device->residentBytes -= sc->chunk.alen;
+			break;
+		}
+		CA_FOREACH_END()
+	}
+	Mix_FreeChunk(sc->loaded);
+	sc->loaded = NULL;
+	sc->chunk.abuf = NULL;
+	sc->chunk.alen = 0;
+}
+static void SoundChunkFree(SoundDevice *device, SoundChunk *sc)
+{
+	if (sc == NULL)
+	{
+		return;
+	}
+	sc->refCount--;
+	if (sc->refCount > 0)
+	{
+		return;
+	}
+	SoundChunkUnload(device, sc);
+	CFREE(sc->path);
+	SoundChunkFreeSrc(sc);
+	CFREE(sc);
+}
+// Evict chunks until under budget, keeping the one that is about to play
+static void SoundTrimResident(SoundDevice *device, const SoundChunk *keep)
+{
+	while (device->residentBytes > SOUND_RESIDENT_BYTES_MAX)
+	{
+		// Evict the least recently used chunk that isn't playing
+		SoundChunk *lru = NULL;
+		CA_FOREACH(SoundChunk *, r, device->resident)
+		if (*r != keep && (lru == NULL || (*r)->lastUsed < lru->lastUsed) &&
+			!SoundChunkIsPlaying(device, *r))
+		{
+			lru = *r;
+		}
+		CA_FOREACH_END()
+		if (lru == NULL)
+		{
+			break;
+		}
+		LOG(LM_SOUND, LL_TRACE, "evicting sound %s",
+			lru->path ? lru->path : "(synthesised)");
+		SoundChunkUnload(device, lru);
+	}
+}
+static bool SoundChunkLoad(SoundDevice *device, SoundChunk *sc)
+{
+	sc->lastUsed = device->useTick++;
+	if (sc->loaded != NULL)
+	{
+		return true;
+	}
+	if (sc->src != NULL)
+	{
+		sc->loaded = sc->decode(sc->src, sc->srcLen, sc->decodeData);
+		if (sc->loaded == NULL)
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to decode sound");
+			// Don't try again
+			SoundChunkFreeSrc(sc);
+			return false;
+		}
+	}
+	else if (sc->path != NULL)
+	{
+		LOG(LM_MAIN, LL_TRACE, "loading sound file %s", sc->path);
+		sc->loaded = Mix_LoadWAV(sc->path);
+		if (sc->loaded == NULL)
+		{
+			LOG(LM_MAIN, LL_ERROR, "failed to load sound %s: %s", sc->path,
+				Mix_GetError());
+			// Don't try again
+			CFREE(sc->path);
+			sc->path = NULL;
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+	sc->chunk = *sc->loaded;
+	CArrayPushBack(&device->resident, &sc);
+	device->residentBytes += sc->chunk.alen;
+	SoundTrimResident(device, sc);
+	return true;
+}
+void SoundPreload(SoundDevice *device, Mix_Chunk *data)
+{
+	if (!device->isInitialised || data == NULL)
+	{
+		return;
+	}
+	SoundChunkLoad(device, (SoundChunk *)data);
 }
 static void SoundDataTerminate(any_t data);
 void SoundAdd(map_t sounds, const char *name, SoundData *sound)
 {
+	sSoundsGeneration++;
 	const int error = hashmap_put(sounds, name, sound);
 	if (error != MAP_OK)
 	{
@@ -191,6 +404,7 @@ void SoundInitialize(SoundDevice *device, const char *path)
 
 	device->sounds = hashmap_new();
 	device->customSounds = hashmap_new();
+	CArrayInit(&device->resident, sizeof(SoundChunk *));
 	char buf[CDOGS_PATH_MAX];
 	GetDataFilePath(buf, path);
 	SoundLoadDir(device->sounds, buf, NULL);
@@ -273,6 +487,7 @@ void SoundReconfigure(SoundDevice *s)
 {
 	s->isInitialised = false;
 	s->music.isInitialised = false;
+	memset(s->voices, 0, sizeof s->voices);
 
 	if (Mix_AllocateChannels(s->channels) != s->channels)
 	{
@@ -306,6 +521,7 @@ void SoundReopen(SoundDevice *s)
 void SoundClear(map_t sounds)
 {
 	hashmap_clear(sounds, SoundDataTerminate);
+	sSoundsGeneration++;
 }
 void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete)
 {
@@ -313,6 +529,11 @@ void SoundTerminate(SoundDevice *device, const bool waitForSoundsComplete)
 
 	hashmap_destroy(device->sounds, SoundDataTerminate);
 	hashmap_destroy(device->customSounds, SoundDataTerminate);
+	sSoundsGeneration++;
+	CArrayTerminate(&sSoundIds);
+	CArrayTerminate(&device->resident);
+	LOG(LM_SOUND, LL_DEBUG, "voices merged(%d) stolen(%d) dropped(%d)",
+		device->voicesMerged, device->voicesStolen, device->voicesDropped);
 
 	MusicPlayerTerminate(&device->music);
 }
@@ -322,11 +543,11 @@ static void SoundDataTerminate(any_t data)
 	switch (s->Type)
 	{
 	case SOUND_NORMAL:
-		Mix_FreeChunk(s->u.normal);
+		SoundChunkFree(&gSoundDevice, s->u.normal);
 		break;
 	case SOUND_RANDOM:
-		CA_FOREACH(Mix_Chunk *, chunk, s->u.random.sounds)
-		Mix_FreeChunk(*chunk);
+		CA_FOREACH(SoundChunk *, chunk, s->u.random.sounds)
+		SoundChunkFree(&gSoundDevice, *chunk);
 		CA_FOREACH_END()
 		CArrayTerminate(&s->u.random.sounds);
 		break;
@@ -338,7 +559,11 @@ static void SoundDataTerminate(any_t data)
 }
 
 #define OUT_OF_SIGHT_DISTANCE_PLUS 100
-static int GetChannel(SoundDevice *s, Mix_Chunk *data);
+static bool MergeVoice(
+	SoundDevice *s, const Mix_Chunk *data, const struct vec2 dp,
+	const Uint8 distance, const bool isMuffled);
+static int GetChannel(
+	SoundDevice *s, Mix_Chunk *data, const Uint8 distance, const int priority);
 static void MuffleEffect(int chan, void *stream, int len, void *udata)
 {
 	UNUSED(chan);
@@ -410,26 +635,139 @@ static void SoundPlayAtPosition(
 	LOG(LM_SOUND, LL_TRACE, "distance(%d) bearing(%d)", distance,
 		bearingDegrees);
 
+	// Decode sound on first play
+	if (!SoundChunkLoad(device, (SoundChunk *)data))
+	{
+		return;
+	}
+
+	// Identical sounds at the same place and time play as one voice
+	if (MergeVoice(device, data, dp, (Uint8)distance, isMuffled))
+	{
+		return;
+	}
+
 	// Get sound channel to play sound
-	const int channel = GetChannel(device, data);
+	// Non-positional sounds (UI, player's own) are more important
+	const int priority = svec2_is_zero(dp) ? 1 : 0;
+	const int channel = GetChannel(device, data, (Uint8)distance, priority);
 	if (channel < 0)
 	{
+		device->voicesDropped++;
 		return;
 	}
 
 	SetSoundEffect(channel, bearingDegrees, (Uint8)distance, isMuffled);
+	SoundVoice *v = &device->voices[channel];
+	v->chunk = data;
+	v->ticks = SDL_GetTicks();
+	v->dp = dp;
+	v->bearingDegrees = bearingDegrees;
+	v->distance = (Uint8)distance;
+	v->isMuffled = isMuffled;
+	v->priority = priority;
+}
+static bool VoiceIsPlaying(const SoundDevice *s, const int channel)
+{
+	return s->voices[channel].chunk != NULL && Mix_Playing(channel) &&
+		   Mix_GetChunk(channel) == s->voices[channel].chunk;
+}
+static bool MergeVoice(
+	SoundDevice *s, const Mix_Chunk *data, const struct vec2 dp,
+	const Uint8 distance, const bool isMuffled)
+{
+	const Uint32 ticks = SDL_GetTicks();
+	for (int i = 0; i < s->channels; i++)
+	{
+		SoundVoice *v = &s->voices[i];
+		if (v->chunk != data || v->isMuffled != isMuffled ||
+			ticks - v->ticks > SOUND_MERGE_MS ||
+			svec2_distance_squared(v->dp, dp) >
+				SQUARED(SOUND_MERGE_RADIUS) ||
+			!VoiceIsPlaying(s, i))
+		{
+			continue;
+		}
+		// Make the existing voice louder instead
+		const int merged = MIN(v->distance, distance) - SOUND_MERGE_BOOST;
+		v->distance = (Uint8)MAX(merged, 0);
+		SetSoundEffect(i, v->bearingDegrees, v->distance, false);
+		s->voicesMerged++;
+		return true;
+	}
+	return false;
+}
+// Whether voice a should be stolen before voice b
+static bool IsVoiceLessImportant(const SoundVoice *a, const SoundVoice *b)
+{
+	if (a->priority != b->priority)
+	{
+		return a->priority < b->priority;
+	}
+	return a->distance > b->distance;
+}
+static int StealChannel(
+	SoundDevice *s, Mix_Chunk *data, const SoundVoice *v, const bool sameOnly)
+{
+	int victim = -1;
+	for (int i = 0; i < s->channels; i++)
+	{
+		if (!VoiceIsPlaying(s, i) ||
+			(sameOnly && s->voices[i].chunk != data))
+		{
+			continue;
+		}
+		if (victim == -1 ||
+			IsVoiceLessImportant(&s->voices[i], &s->voices[victim]))
+		{
+			victim = i;
+		}
+	}
+	if (victim == -1 || !IsVoiceLessImportant(&s->voices[victim], v))
+	{
+		return -1;
+	}
+	// Halting also removes the channel's effects
+	Mix_HaltChannel(victim);
+	s->voicesStolen++;
+	return Mix_PlayChannel(victim, data, 0);
+}
+static int CountInstances(const SoundDevice *s, const Mix_Chunk *data)
+{
+	int count = 0;
+	for (int i = 0; i < s->channels; i++)
+	{
+		if (s->voices[i].chunk == data && VoiceIsPlaying(s, i))
+		{
+			count++;
+		}
+	}
+	return count;
 }
-static int GetChannel(SoundDevice *s, Mix_Chunk *data)
+static int GetChannel(
+	SoundDevice *s, Mix_Chunk *data, const Uint8 distance, const int priority)
 {
+	SoundVoice v;
+	memset(&v, 0, sizeof v);
+	v.distance = distance;
+	v.priority = priority;
+	if (CountInstances(s, data) >= SOUND_INSTANCES_MAX)
+	{
+		return StealChannel(s, data, &v, true);
+	}
 	for (;;)
 	{
 		const int channel = Mix_PlayChannel(-1, data, 0);
-		if (channel >= 0 || s->channels > 128)
+		if (channel >= 0)
 		{
 			return channel;
 		}
+		if (s->channels >= SOUND_CHANNELS_MAX)
+		{
+			return StealChannel(s, data, &v, false);
+		}
 		// Check if we cannot play the sound; allocate more channels
-		s->channels *= 2;
+		s->channels = MIN(s->channels * 2, SOUND_CHANNELS_MAX);
 		if (Mix_AllocateChannels(s->channels) != s->channels)
 		{
 			LOG(LM_SOUND, LL_ERROR, "Cannot allocate channels");
@@ -602,12 +940,130 @@ Mix_Chunk *StrSound(const char *s)
 	}
 	return NULL;
 }
+typedef struct
+{
+	uint32_t Id; // 0 for an empty slot
+	const char *Name;
+	SoundData *Data;
+} SoundIdEntry;
+static int AddSoundIdEntry(any_t data, any_t key);
+static void SoundIdsUpdate(void)
+{
+	if (sSoundIdsGeneration == sSoundsGeneration)
+	{
+		return;
+	}
+	sSoundIdsGeneration = sSoundsGeneration;
+	CArrayTerminate(&sSoundIds);
+	if (gSoundDevice.sounds == NULL)
+	{
+		return;
+	}
+	// Open addressing table indexed by ID, at most half full
+	size_t size = 16;
+	while (size < 2 * (size_t)(hashmap_length(gSoundDevice.sounds) +
+							   hashmap_length(gSoundDevice.customSounds)))
+	{
+		size *= 2;
+	}
+	CArrayInitFillZero(&sSoundIds, sizeof(SoundIdEntry), size);
+	// Custom sounds are added first so they override built-in ones of the
+	// same name, and so ID
+	hashmap_iterate_keys(
+		gSoundDevice.customSounds, AddSoundIdEntry, gSoundDevice.customSounds);
+	hashmap_iterate_keys(
+		gSoundDevice.sounds, AddSoundIdEntry, gSoundDevice.sounds);
+}
+static SoundIdEntry *SoundIdFind(const uint32_t id)
+{
+	if (sSoundIds.size == 0)
+	{
+		return NULL;
+	}
+	const size_t mask = sSoundIds.size - 1;
+	for (size_t i = id & mask;; i = (i + 1) & mask)
+	{
+		SoundIdEntry *e = CArrayGet(&sSoundIds, i);
+		if (e->Id == id || e->Id == 0)
+		{
+			return e;
+		}
+	}
+}
+static int AddSoundIdEntry(any_t data, any_t key)
+{
+	const char *name = key;
+	SoundIdEntry *e = SoundIdFind(StrSoundId(name));
+	if (e->Id != 0)
+	{
+		if (strcmp(e->Name, name) != 0)
+		{
+			LOG(LM_SOUND, LL_ERROR, "sound ID clash between %s and %s",
+				e->Name, name);
+		}
+		return MAP_OK;
+	}
+	e->Id = StrSoundId(name);
+	e->Name = name;
+	hashmap_get(data, name, (any_t *)&e->Data);
+	return MAP_OK;
+}
+uint32_t StrSoundId(const char *s)
+{
+	if (s == NULL || strlen(s) == 0)
+	{
+		return 0;
+	}
+	// FNV-1a hash of the name, avoiding 0
+	uint32_t id = 2166136261u;
+	for (; *s != '\0'; s++)
+	{
+		id = (id ^ (uint8_t)*s) * 16777619u;
+	}
+	return id == 0 ? 1 : id;
+}
+Mix_Chunk *SoundIdGet(const uint32_t id)
+{
+	if (id == 0 || !gSoundDevice.isInitialised)
+	{
+		return NULL;
+	}
+	SoundIdsUpdate();
+	const SoundIdEntry *e = SoundIdFind(id);
+	return e != NULL && e->Id == id ? SoundDataGet(e->Data) : NULL;
+}
+uint32_t SoundHandleId(SoundHandle *h)
+{
+	if (h->id == 0)
+	{
+		h->id = StrSoundId(h->Name);
+	}
+	return h->id;
+}
+Mix_Chunk *SoundHandleGet(SoundHandle *h)
+{
+	if (!gSoundDevice.isInitialised)
+	{
+		return NULL;
+	}
+	// Resolve the handle once per change to the loaded sounds
+	if (h->generation != sSoundsGeneration)
+	{
+		const uint32_t id = SoundHandleId(h);
+		SoundIdsUpdate();
+		const SoundIdEntry *e = SoundIdFind(id);
+		h->data = e != NULL && e->Id == id ? e->Data : NULL;
+		h->generation = sSoundsGeneration;
+	}
+	return h->data != NULL ? SoundDataGet(h->data) : NULL;
+}
+
 static Mix_Chunk *SoundDataGet(SoundData *s)
 {
 	switch (s->Type)
 	{
 	case SOUND_NORMAL:
-		return s->u.normal;
+		return s->u.normal != NULL ? &s->u.normal->chunk : NULL;
 	case SOUND_RANDOM:
 		if (s->u.random.sounds.size == 0)
 		{
@@ -622,9 +1078,9 @@ static Mix_Chunk *SoundDataGet(SoundData *s)
 			{
 				idx = rand() % s->u.random.sounds.size;
 			}
-			Mix_Chunk **sound = CArrayGet(&s->u.random.sounds, idx);
+			SoundChunk **sound = CArrayGet(&s->u.random.sounds, idx);
 			s->u.random.lastPlayed = idx;
-			return *sound;
+			return *sound != NULL ? &(*sound)->chunk : NULL;
 		}
 	default:
 		CASSERT(false, "Unknown sound data type");
@@ -76,19 +76,52 @@ typedef enum
 	SOUND_RANDOM
 } SoundType;
 
+// Sound sample, decoded on first play if path or src is set.
+// chunk must be first and stays at a fixed address so that the Mix_Chunk
+// pointers returned by StrSound remain valid when the samples are evicted.
+typedef struct
+{
+	Mix_Chunk chunk;
+	Mix_Chunk *loaded; // NULL if not decoded yet
+	char *path;		   // NULL if not loaded from file
+	// Compact source data and its decoder, e.g. for synthesised sounds
+	Mix_Chunk *(*decode)(const void *, const size_t, const void *);
+	const void *decodeData;
+	const void *src;
+	size_t srcLen;
+	void *ownedSrc; // src, if the chunk owns it
+	int lastUsed;
+	// Shared by sound aliases
+	int refCount;
+} SoundChunk;
+
 typedef struct
 {
 	SoundType Type;
 	union {
-		Mix_Chunk *normal;
+		SoundChunk *normal;
 		struct
 		{
-			CArray sounds; // of Mix_Chunk *
+			CArray sounds; // of SoundChunk *
 			int lastPlayed;
 		} random;
 	} u;
 } SoundData;
 
+#define SOUND_CHANNELS_MAX 128
+
+// Sound playing on a mixer channel
+typedef struct
+{
+	const Mix_Chunk *chunk;
+	Uint32 ticks; // when it started playing
+	struct vec2 dp;
+	Sint16 bearingDegrees;
+	Uint8 distance;
+	bool isMuffled;
+	int priority;
+} SoundVoice;
+
 typedef struct
 {
 	MusicPlayer music;
@@ -103,6 +136,18 @@ typedef struct
 
 	map_t sounds;		// of SoundData
 	map_t customSounds; // of SoundData
+
+	// Decoded file sounds, evicted least recently used first when over
+	// budget
+	CArray resident; // of SoundChunk *
+	size_t residentBytes;
+	int useTick;
+
+	SoundVoice voices[SOUND_CHANNELS_MAX];
+	// Voice manager stats
+	int voicesMerged;
+	int voicesStolen;
+	int voicesDropped;
 } SoundDevice;
 
 extern SoundDevice gSoundDevice;
@@ -110,6 +155,21 @@ extern SoundDevice gSoundDevice;
 void SoundInitialize(SoundDevice *device, const char *path);
 void SoundLoadDir(map_t sounds, const char *path, const char *prefix);
 void SoundAdd(map_t sounds, const char *name, SoundData *sound);
+// Wrap an already decoded chunk; it is never evicted
+SoundChunk *SoundChunkNew(Mix_Chunk *data);
+// Keep a copy of src and decode it on first play; the decoded chunk must
+// own its samples so that it can be freed when evicted
+SoundChunk *SoundChunkNewLazy(
+	Mix_Chunk *(*decode)(const void *, const size_t, const void *),
+	const void *decodeData, const void *src, const size_t srcLen);
+// As above but without copying src, which must outlive the chunk
+SoundChunk *SoundChunkNewLazyRef(
+	Mix_Chunk *(*decode)(const void *, const size_t, const void *),
+	const void *decodeData, const void *src, const size_t srcLen);
+// Share the chunk with another sound; each reference is freed separately
+SoundChunk *SoundChunkRef(SoundChunk *sc);
+// Decode ahead of time to avoid a stall on first play
+void SoundPreload(SoundDevice *device, Mix_Chunk *data);
 void SoundReconfigure(SoundDevice *s);
 void SoundReopen(SoundDevice *s);
 void SoundClear(map_t sounds);
@@ -127,3 +187,25 @@ void SoundPlayAtPlusDistance(
 	const int plusDistance);
 
 Mix_Chunk *StrSound(const char *s);
+
+// Sounds can also be referred to by ID, which is a hash of the name and is
+// small enough for network messages. IDs don't depend on which sounds are
+// loaded, so they stay valid as sounds are added or cleared, and peers agree
+// on them. 0 is no sound.
+uint32_t StrSoundId(const char *s);
+Mix_Chunk *SoundIdGet(const uint32_t id);
+
+// Handle to a sound whose ID and data are looked up once, and again only after
+// sounds are added or cleared. Use for sounds played in the game loop, e.g.
+// static SoundHandle spawn = SOUND_HANDLE("spawn");
+// SoundPlay(&gSoundDevice, SoundHandleGet(&spawn));
+typedef struct
+{
+	const char *Name;
+	uint32_t id;
+	SoundData *data;
+	int generation;
+} SoundHandle;
+#define SOUND_HANDLE(_name) {_name, 0, NULL, -1}
+uint32_t SoundHandleId(SoundHandle *h);
+Mix_Chunk *SoundHandleGet(SoundHandle *h);
@@ -0,0 +1,203 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "texture_atlas.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "grafx.h"
+#include "log.h"
+#include "texture.h"
+
+#define ATLAS_PAGE_SIZE 2048
+// Gap between packed pics, so that linear filtering doesn't bleed
+#define ATLAS_PADDING 1
+
+
+void TextureAtlasInit(TextureAtlas *a)
+{
+	memset(a, 0, sizeof *a);
+	CArrayInit(&a->Pages, sizeof(SDL_Texture *));
+}
+void TextureAtlasTerminate(TextureAtlas *a)
+{
+	TextureAtlasClear(a);
+	CArrayTerminate(&a->Pages);
+}
+void TextureAtlasClear(TextureAtlas *a)
+{
+	CA_FOREACH(SDL_Texture *, t, a->Pages)
+	SDL_DestroyTexture(*t);
+	CA_FOREACH_END()
+	CArrayClear(&a->Pages);
+	a->cursor = svec2i_zero();
+	a->shelfH = 0;
+}
+
+void TextureAtlasRemovePage(TextureAtlas *a, const SDL_Texture *page)
+{
+	CA_FOREACH(SDL_Texture *, t, a->Pages)
+	if (*t != page)
+	{
+		continue;
+	}
+	SDL_DestroyTexture(*t);
+	const bool isLast = _ca_index == (int)a->Pages.size - 1;
+	CArrayDelete(&a->Pages, _ca_index);
+	if (isLast)
+	{
+		// Don't pack into the previous page, which is already full
+		a->cursor = svec2i(0, a->PageSize.y);
+		a->shelfH = 0;
+	}
+	break;
+	CA_FOREACH_END()
+}
+
+static struct vec2i GetPageSize(SDL_Renderer *r)
+{
+	struct vec2i size = svec2i(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+	SDL_RendererInfo info;
+	if (SDL_GetRendererInfo(r, &info) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot get renderer info: %s", SDL_GetError());
+		return size;
+	}
+	// 0 means no limit
+	if (info.max_texture_width > 0)
+	{
+		size.x = MIN(size.x, info.max_texture_width);
+	}
+	if (info.max_texture_height > 0)
+	{
+		size.y = MIN(size.y, info.max_texture_height);
+	}
+	return size;
+}
+static bool AddPage(TextureAtlas *a)
+{
+	SDL_Renderer *r = gGraphicsDevice.gameWindow.renderer;
+	if (svec2i_is_zero(a->PageSize))
+	{
+		a->PageSize = GetPageSize(r);
+	}
+	SDL_Texture *t = TextureCreate(
+		r, SDL_TEXTUREACCESS_STATIC, a->PageSize, SDL_BLENDMODE_BLEND, 255);
+	if (t == NULL)
+	{
+		return false;
+	}
+	// Clear the page so the padding between pics is transparent
+	Uint32 *blank;
+	CCALLOC(blank, a->PageSize.x * a->PageSize.y * sizeof *blank);
+	const int res =
+		SDL_UpdateTexture(t, NULL, blank, a->PageSize.x * sizeof *blank);
+	CFREE(blank);
+	if (res != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot clear atlas page: %s", SDL_GetError());
+		SDL_DestroyTexture(t);
+		return false;
+	}
+	CArrayPushBack(&a->Pages, &t);
+	a->cursor = svec2i_zero();
+	a->shelfH = 0;
+	LOG(LM_GFX, LL_DEBUG, "added atlas page %d (%dx%d)", (int)a->Pages.size,
+		a->PageSize.x, a->PageSize.y);
+	return true;
+}
+
+bool TextureAtlasAdd(TextureAtlas *a, Pic *p)
+{
+	if (PicIsNone(p))
+	{
+		return false;
+	}
+	const struct vec2i size = PicPixelSize(p);
+	const struct vec2i padded =
+		svec2i_add(size, svec2i(ATLAS_PADDING, ATLAS_PADDING));
+	if (a->Pages.size > 0 &&
+		(padded.x > a->PageSize.x || padded.y > a->PageSize.y))
+	{
+		return false;
+	}
+	// Start a new shelf if this row is full
+	if (a->Pages.size > 0 && a->cursor.x + padded.x > a->PageSize.x)
+	{
+		a->cursor.x = 0;
+		a->cursor.y += a->shelfH;
+		a->shelfH = 0;
+	}
+	// Start a new page if this page is full
+	if (a->Pages.size == 0 || a->cursor.y + padded.y > a->PageSize.y)
+	{
+		if (!AddPage(a))
+		{
+			return false;
+		}
+		if (padded.x > a->PageSize.x || padded.y > a->PageSize.y)
+		{
+			return false;
+		}
+	}
+	SDL_Texture **page = CArrayGet(&a->Pages, a->Pages.size - 1);
+	const SDL_Rect dst = {a->cursor.x, a->cursor.y, size.x, size.y};
+	if (SDL_UpdateTexture(*page, &dst, p->Data, size.x * sizeof(Uint32)) != 0)
+	{
+		LOG(LM_GFX, LL_ERROR, "cannot update atlas page: %s", SDL_GetError());
+		return false;
+	}
+	PicSetSharedTex(p, *page, a->cursor);
+	a->cursor.x += padded.x;
+	a->shelfH = MAX(a->shelfH, padded.y);
+	return true;
+}
+
+static int ComparePicHeight(const void *v1, const void *v2);
+void TextureAtlasAddPics(TextureAtlas *a, CArray *pics)
+{
+	if (pics->size == 0)
+	{
+		return;
+	}
+	qsort(pics->data, pics->size, pics->elemSize, ComparePicHeight);
+	CA_FOREACH(Pic *, p, *pics)
+	TextureAtlasAdd(a, *p);
+	CA_FOREACH_END()
+}
+static int ComparePicHeight(const void *v1, const void *v2)
+{
+	const Pic *const *p1 = v1;
+	const Pic *const *p2 = v2;
+	// Tallest first, then widest first
+	const struct vec2i s1 = PicPixelSize(*p1);
+	const struct vec2i s2 = PicPixelSize(*p2);
+	if (s1.y != s2.y)
+	{
+		return s2.y - s1.y;
+	}
+	return s2.x - s1.x;
+}
@@ -0,0 +1,56 @@
+/*
+ Copyright (c) 2025 Cong Xu
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without
+ modification, are permitted provided that the following conditions are met:
+ 
+ Redistributions of source code must retain the above copyright notice, this
+ list of conditions and the following disclaimer.
+ Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+ */
+#pragma once
+
+#include "c_array.h"
+#include "pic.h"
+
+// Packs many small pics into a few large texture pages, so that consecutive
+// draws share the same texture and can be batched by the renderer.
+// Pages are filled using simple shelf packing; pics are never removed
+// individually, instead whole pages are removed or the atlas is cleared.
+typedef struct
+{
+	struct vec2i PageSize;
+	CArray Pages;	// of SDL_Texture *
+	// Packing cursor within the last page
+	struct vec2i cursor;
+	int shelfH;
+} TextureAtlas;
+
+void TextureAtlasInit(TextureAtlas *a);
+void TextureAtlasTerminate(TextureAtlas *a);
+// Destroy all pages; pics that were packed must be re-packed or have their
+// own textures made before they are drawn again
+void TextureAtlasClear(TextureAtlas *a);
+// Destroy one page; pics that were packed in it must not be drawn again
+void TextureAtlasRemovePage(TextureAtlas *a, const SDL_Texture *page);
+
+// Copy the pic into the atlas and make it draw from the atlas page
+// Returns false if the pic cannot fit, in which case it keeps its own texture
+bool TextureAtlasAdd(TextureAtlas *a, Pic *p);
+// Pack many pics at once; sorting them by height packs them more tightly
+void TextureAtlasAddPics(TextureAtlas *a, CArray *pics);	// of Pic *
@@ -86,6 +86,15 @@ extern bool gFalse;
 		}                                                                     \
 	}
 
+// Allocation counts, for benchmarks that build with CDOGS_COUNT_ALLOCS
+#ifdef CDOGS_COUNT_ALLOCS
+extern int gAllocCount;
+extern int gFreeCount;
+#define _CCOUNT(_count) _count++;
+#else
+#define _CCOUNT(_count)
+#endif
+
 // Even though malloc(0) may return NULL, we don't account for it for
 // simplicity and to allow code linters to work better
 #define _CCHECKALLOC(_func, _var, _size)                                      \
@@ -94,6 +103,7 @@ extern bool gFalse;
 		{                                                                     \
 			exit(1);                                                          \
 		}                                                                     \
+		_CCOUNT(gAllocCount)                                                  \
 	}
 
 #define CMALLOC(_var, _size)                                                  \
@@ -120,6 +130,7 @@ extern bool gFalse;
 #define CFREE(_var)                                                           \
 	{                                                                         \
 		free(_var);                                                           \
+		_CCOUNT(gFreeCount)                                                   \
 	}
 
 #define UNUSED(expr) (void)(expr);
@@ -125,6 +125,56 @@ GameLoopData *RunGame(Campaign *co, struct MissionOptions *m, Map *map)
 	g->SuperhotMode = ConfigGetBool(&gConfig, "Game.Superhot(tm)Mode");
 	return g;
 }
+static MapBuilder sMapBuilder;
+static bool sMapBuilding = false;
+static void GameBuildMapStart(
+	Campaign *co, struct MissionOptions *m, Map *map)
+{
+	if (m->MapBuildStarted)
+	{
+		return;
+	}
+	// Drop any build left over from a mission that was set up again
+	GameBuildMapCancel();
+	CampaignSeedRandom(co);
+	MapBuildStart(
+		&sMapBuilder, map, m->missionData, !co->IsClient, m->index,
+		co->Entry.Mode, &co->Setting.characters);
+	sMapBuilding = true;
+	m->MapBuildStarted = true;
+}
+void GameBuildMapStep(Campaign *co, struct MissionOptions *m, Map *map)
+{
+	GameBuildMapStart(co, m, map);
+	if (sMapBuilding && sMapBuilder.stage < MAP_BUILD_STAGE_DYNAMIC)
+	{
+		MapBuildStep(&sMapBuilder);
+	}
+}
+void GameBuildMap(Campaign *co, struct MissionOptions *m, Map *map)
+{
+	GameBuildMapStart(co, m, map);
+	if (!sMapBuilding)
+	{
+		return;
+	}
+	while (MapBuildStep(&sMapBuilder))
+	{
+	}
+	MapBuilderTerminate(&sMapBuilder);
+	sMapBuilding = false;
+}
+void GameBuildMapCancel(void)
+{
+	if (!sMapBuilding)
+	{
+		return;
+	}
+	MapBuilderTerminate(&sMapBuilder);
+	sMapBuilding = false;
+	// Some map types queue pickups, like keys, while building their tiles
+	GameEventsClear(&gGameEvents);
+}
 static void RunGameReset(RunGameData *rData)
 {
 	// Clear the background
@@ -155,11 +205,7 @@ static void RunGameOnEnter(GameLoopData *data)
 
 	RunGameReset(rData);
 
-	CampaignSeedRandom(rData->co);
-	MapBuild(
-		rData->map, rData->m->missionData, !rData->co->IsClient,
-		rData->m->index, rData->co->Entry.Mode,
-		&rData->co->Setting.characters);
+	GameBuildMap(rData->co, rData->m, rData->map);
 
 	// Seed random if PVP mode (otherwise players will always spawn in same
 	// position)
@@ -61,6 +61,14 @@
 #include "pause_menu.h"
 
 GameLoopData *RunGame(Campaign *co, struct MissionOptions *m, Map *map);
+// Build the mission's map a stage per call while showing screens before
+// the mission, to take map generation off the mission start. This stops
+// short of placing objects, pickups and actors, which waits for the mission.
+void GameBuildMapStep(Campaign *co, struct MissionOptions *m, Map *map);
+// Finish building the mission's map
+void GameBuildMap(Campaign *co, struct MissionOptions *m, Map *map);
+// Abandon a partly built map and the events it queued
+void GameBuildMapCancel(void);
 
 typedef struct
 {
@@ -32,8 +32,10 @@
 
 #include "config.h"
 #include "events.h"
+#include "font.h"
 #include "net_client.h"
 #include "net_server.h"
+#include "pic_manager.h"
 #include "sounds.h"
 
 #ifdef __EMSCRIPTEN__
@@ -289,6 +291,8 @@ bool LoopRunnerRunInner(LoopRunInnerData *ctx)
 			WindowContextPostRender(&gGraphicsDevice.secondWindow);
 		}
 		ctx->data->HasDrawnFirst = true;
+		PicManagerTrimMaskedSprites(&gPicManager);
+		FontUpdateTextRuns();
 	}
 
 	return true;
@@ -59,6 +59,8 @@ typedef struct
 	GraphicsDevice *graphics;
 	credits_displayer_t creditsDisplayer;
 	CustomCampaigns campaigns;
+	// Incremented whenever scanned campaigns are added to the lists
+	int campaignsGeneration;
 	GameMode lastGameMode;
 	bool wasClient;
 	DrawBuffer buffer;
@@ -71,6 +73,7 @@ static void MenuResetSize(MenuSystem *ms);
 static void MenuCreateAll(
 	MainMenuData *data, LoopRunner *l, EventHandlers *handlers);
 static void MainMenuReset(MainMenuData *data);
+static void CampaignsMenuRefreshCurrent(MenuSystem *ms);
 static void MainMenuTerminate(GameLoopData *data);
 static void MainMenuOnEnter(GameLoopData *data);
 static void MainMenuOnExit(GameLoopData *data);
@@ -85,6 +88,7 @@ GameLoopData *MainMenu(GraphicsDevice *graphics, LoopRunner *l)
 	LoadCredits(&data->creditsDisplayer, colorPurple, colorDarker);
 	memset(&data->campaigns, 0, sizeof data->campaigns);
 	LoadAllCampaigns(&data->campaigns);
+	data->campaignsGeneration = 0;
 	data->lastGameMode = GAME_MODE_QUICK_PLAY;
 	data->wasClient = false;
 	MenuCreateAll(data, l, &gEventHandlers);
@@ -230,6 +234,14 @@ static GameLoopResult MainMenuUpdate(GameLoopData *data, LoopRunner *l)
 	LOSSetAllVisible(&mData->rData.map->LOS);
 	GameUpdate(&mData->rData, 1, NULL);
 
+	if (CampaignsUpdateScan(&mData->campaigns))
+	{
+		mData->campaignsGeneration++;
+	}
+	// Campaign menu items point into the lists, so refresh them before
+	// handling input
+	CampaignsMenuRefreshCurrent(&mData->ms);
+
 	const GameLoopResult result = MenuUpdate(&mData->ms);
 	if (result == UPDATE_RESULT_OK)
 	{
@@ -304,7 +316,7 @@ static menu_t *MenuCreateContinue(
 	const char *name, MainMenuData *mainMenu, const CampaignEntry *entry);
 static menu_t *MenuCreateCampaigns(
 	const char *name, const char *title, MainMenuData *mainMenu,
-	CampaignList *list, const GameMode mode);
+	CampaignList *root, const char *folder, const GameMode mode);
 static menu_t *CreateJoinLANGame(
 	const char *name, const char *title, MenuSystem *ms, LoopRunner *l);
 static void CheckLANServers(menu_t *menu, void *data);
@@ -319,15 +331,16 @@ static menu_t *MenuCreateStart(
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
 				  "Campaign", "Select a campaign:", mainMenu,
-				  &mainMenu->campaigns.campaignList, GAME_MODE_NORMAL));
+				  &mainMenu->campaigns.campaignList, "", GAME_MODE_NORMAL));
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
 				  "Dogfight", "Select a dogfight scenario:", mainMenu,
-				  &mainMenu->campaigns.dogfightList, GAME_MODE_DOGFIGHT));
+				  &mainMenu->campaigns.dogfightList, "", GAME_MODE_DOGFIGHT));
 	MenuAddSubmenu(
 		menu, MenuCreateCampaigns(
 				  "Deathmatch", "Select a deathmatch scenario:", mainMenu,
-				  &mainMenu->campaigns.dogfightList, GAME_MODE_DEATHMATCH));
+				  &mainMenu->campaigns.dogfightList, "",
+				  GAME_MODE_DEATHMATCH));
 	MenuAddSubmenu(
 		menu, CreateJoinLANGame(
 				  "Join LAN game", "Choose LAN server", &mainMenu->ms, l));
@@ -414,25 +427,90 @@ static void CampaignsDisplayFilename(
 	opts.Pad.x = size.x / 12;
 	FontStrOpt(s, pos, opts);
 }
+typedef struct
+{
+	MainMenuData *MainMenu;
+	const char *Title;
+	CampaignList *Root;
+	// Subfolder path from the root list, e.g. "a/b/"
+	char Folder[CDOGS_PATH_MAX];
+	GameMode Mode;
+	int Generation;
+} CampaignsMenuData;
+static void CampaignsMenuRefresh(menu_t *menu, void *data);
 static menu_t *MenuCreateCampaigns(
 	const char *name, const char *title, MainMenuData *mainMenu,
-	CampaignList *list, const GameMode mode)
+	CampaignList *root, const char *folder, const GameMode mode)
 {
 	menu_t *menu = MenuCreateNormal(name, title, MENU_TYPE_NORMAL, 0);
 	menu->u.normal.maxItems = 20;
 	menu->u.normal.align = MENU_ALIGN_CENTER;
-	CA_FOREACH(CampaignList, subList, list->subFolders)
-	char folderName[CDOGS_FILENAME_MAX];
-	sprintf(folderName, "%s/", subList->Name);
-	MenuAddSubmenu(
-		menu, MenuCreateCampaigns(folderName, title, mainMenu, subList, mode));
-	CA_FOREACH_END()
-	CA_FOREACH(CampaignEntry, e, list->list)
-	MenuAddSubmenu(menu, MenuCreateCampaignItem(mainMenu, e, mode));
-	CA_FOREACH_END()
+	CampaignsMenuData *data;
+	CMALLOC(data, sizeof *data);
+	data->MainMenu = mainMenu;
+	data->Title = title;
+	data->Root = root;
+	strcpy(data->Folder, folder);
+	data->Mode = mode;
+	data->Generation = -1;
+	// Campaigns are still being scanned; create the items when entering
+	// and whenever more are found
+	MenuSetPostEnterFunc(menu, CampaignsMenuRefresh, data, false);
+	MenuSetPostUpdateFunc(menu, CampaignsMenuRefresh, data, true);
 	MenuSetCustomDisplay(menu, CampaignsDisplayFilename, NULL);
+	CampaignsMenuRefresh(menu, data);
 	return menu;
 }
+static void CampaignsMenuRefresh(menu_t *menu, void *data)
+{
+	CampaignsMenuData *mData = data;
+	if (mData->Generation == mData->MainMenu->campaignsGeneration)
+	{
+		return;
+	}
+	mData->Generation = mData->MainMenu->campaignsGeneration;
+
+	// Clear and recreate all menu items, keeping the selection
+	const int index = menu->u.normal.index;
+	const int scroll = menu->u.normal.scroll;
+	MenuClearSubmenus(menu);
+	const CampaignList *list =
+		CampaignListGetFolder(mData->Root, mData->Folder, false);
+	if (list != NULL)
+	{
+		CA_FOREACH(CampaignList, subList, list->subFolders)
+		char folderName[CDOGS_FILENAME_MAX];
+		sprintf(folderName, "%s/", subList->Name);
+		char folder[CDOGS_PATH_MAX];
+		sprintf(folder, "%s%s/", mData->Folder, subList->Name);
+		MenuAddSubmenu(
+			menu, MenuCreateCampaigns(
+					  folderName, mData->Title, mData->MainMenu, mData->Root,
+					  folder, mData->Mode));
+		CA_FOREACH_END()
+		CA_FOREACH(CampaignEntry, e, list->list)
+		MenuAddSubmenu(
+			menu, MenuCreateCampaignItem(mData->MainMenu, e, mData->Mode));
+		CA_FOREACH_END()
+	}
+	const int numItems = (int)menu->u.normal.subMenus.size;
+	if (CampaignsIsScanning(&mData->MainMenu->campaigns))
+	{
+		MenuAddSubmenu(menu, MenuCreateSeparator("Scanning..."));
+	}
+	if (numItems > 0)
+	{
+		menu->u.normal.index = MIN(index, numItems - 1);
+		menu->u.normal.scroll = MIN(scroll, menu->u.normal.index);
+	}
+}
+static void CampaignsMenuRefreshCurrent(MenuSystem *ms)
+{
+	if (ms->current->customPostUpdateFunc == CampaignsMenuRefresh)
+	{
+		CampaignsMenuRefresh(ms->current, ms->current->customPostUpdateData);
+	}
+}
 
 static menu_t *MenuCreateCampaignItem(
 	MainMenuData *mainMenu, CampaignEntry *entry, const GameMode mode)
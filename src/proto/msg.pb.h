@@ -138,7 +138,7 @@ typedef struct _NMapObjectAdd {
 } NMapObjectAdd;
 
 typedef struct _NSound {
-    char Sound[128];
+    uint32_t Sound;
     bool has_Pos;
     NVec2 Pos;
     uint32_t Distance;
@@ -434,7 +434,7 @@ extern "C" {
 #define NMapObjectAdd_init_default               {0, "", false, NVec2_init_default, 0, 0, false, NColor_init_default}
 #define NMapObjectRemove_init_default            {0, 0, 0}
 #define NScore_init_default                      {0, 0}
-#define NSound_init_default                      {"", false, NVec2_init_default, 0}
+#define NSound_init_default                      {0, false, NVec2_init_default, 0}
 #define NVec2i_init_default                      {0, 0}
 #define NVec2_init_default                       {0, 0}
 #define NGameBegin_init_default                  {0}
@@ -487,7 +487,7 @@ extern "C" {
 #define NMapObjectAdd_init_zero                  {0, "", false, NVec2_init_zero, 0, 0, false, NColor_init_zero}
 #define NMapObjectRemove_init_zero               {0, 0, 0}
 #define NScore_init_zero                         {0, 0}
-#define NSound_init_zero                         {"", false, NVec2_init_zero, 0}
+#define NSound_init_zero                         {0, false, NVec2_init_zero, 0}
 #define NVec2i_init_zero                         {0, 0}
 #define NVec2_init_zero                          {0, 0}
 #define NGameBegin_init_zero                     {0}
@@ -884,7 +884,7 @@ X(a, STATIC,   SINGULAR, INT32,    Score,             2)
 #define NScore_DEFAULT NULL
 
 #define NSound_FIELDLIST(X, a) \
-X(a, STATIC,   SINGULAR, STRING,   Sound,             1) \
+X(a, STATIC,   SINGULAR, UINT32,   Sound,             1) \
 X(a, STATIC,   OPTIONAL, MESSAGE,  Pos,               2) \
 X(a, STATIC,   SINGULAR, UINT32,   Distance,          3)
 #define NSound_CALLBACK NULL
@@ -1333,7 +1333,7 @@ extern const pb_msgdesc_t NMissionEnd_msg;
 #define NRescueCharacter_size                    6
 #define NScore_size                              17
 #define NServerInfo_size                         95
-#define NSound_size                              148
+#define NSound_size                              24
 #define NThingDamage_size                        214
 #define NTileSet_size                            425
 #define NTrigger_size                            30
@@ -0,0 +1,94 @@
+// Micro-benchmark for c_hashmap; not run as part of the test suite.
+// Keys mimic pic manager names, e.g. "chars/heads/ogre/12_0_3".
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <c_hashmap/hashmap.h>
+
+#define NUM_KEYS 8192
+#define NUM_LOOKUPS (NUM_KEYS * 256)
+#define NUM_REPEATS 5
+
+static char keys[NUM_KEYS][64];
+static char missKeys[NUM_KEYS][64];
+
+static double Elapsed(const clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int CountKey(any_t data, any_t key)
+{
+	(void)key;
+	(*(int *)data)++;
+	return MAP_OK;
+}
+
+int main(void)
+{
+	static const char *dirs[] = {
+		"chars/heads/", "chars/bodies/", "chars/legs/", "guns/", "bullets/",
+		"mapobjs/", "tiles/"};
+	for (int i = 0; i < NUM_KEYS; i++)
+	{
+		sprintf(
+			keys[i], "%s%d/%d_%d_%d", dirs[i % 7], i / 7, i % 8, i % 3, i);
+		sprintf(missKeys[i], "missing/%d", i);
+	}
+
+	double putTime = 0, hitTime = 0, missTime = 0, iterTime = 0;
+	int checksum = 0;
+	for (int r = 0; r < NUM_REPEATS; r++)
+	{
+		clock_t start = clock();
+		map_t m = hashmap_new();
+		for (int i = 0; i < NUM_KEYS; i++)
+		{
+			hashmap_put(m, keys[i], (any_t)(intptr_t)(i + 1));
+		}
+		putTime += Elapsed(start);
+
+		start = clock();
+		unsigned idx = 12345;
+		for (int i = 0; i < NUM_LOOKUPS; i++)
+		{
+			any_t v;
+			idx = idx * 1103515245 + 12345;
+			if (hashmap_get(m, keys[(idx >> 8) % NUM_KEYS], &v) == MAP_OK)
+			{
+				checksum += (int)(intptr_t)v;
+			}
+		}
+		hitTime += Elapsed(start);
+
+		start = clock();
+		for (int i = 0; i < NUM_LOOKUPS / 16; i++)
+		{
+			if (hashmap_get(m, missKeys[i % NUM_KEYS], NULL) == MAP_OK)
+			{
+				checksum++;
+			}
+		}
+		missTime += Elapsed(start);
+
+		start = clock();
+		for (int i = 0; i < 256; i++)
+		{
+			hashmap_iterate_keys(m, CountKey, &checksum);
+		}
+		iterTime += Elapsed(start);
+
+		hashmap_free(m);
+	}
+
+	const double ns = 1e9 / NUM_REPEATS;
+	printf("put:     %6.1f ns/op\n", putTime * ns / NUM_KEYS);
+	printf("get hit: %6.1f ns/op\n", hitTime * ns / NUM_LOOKUPS);
+	printf("get miss:%6.1f ns/op\n", missTime * ns / (NUM_LOOKUPS / 16));
+	printf("iterate: %6.1f ns/element\n", iterTime * ns / (NUM_KEYS * 256));
+	printf("(checksum %d)\n", checksum);
+	return 0;
+}
@@ -1,5 +1,6 @@
 #include <cbehave/cbehave.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <c_hashmap/hashmap.h>
@@ -23,6 +24,58 @@ FEATURE(hashmap_put, "Hashmap put")
 
 		hashmap_free(map);
 	SCENARIO_END
+
+	SCENARIO("Put an existing key")
+		GIVEN("a hashmap with a value")
+			map_t map = hashmap_new();
+			int value1 = 1;
+			hashmap_put(map, "somekey", &value1);
+
+		WHEN("I put a new value with the same key")
+			int value2 = 2;
+			hashmap_put(map, "somekey", &value2);
+
+		THEN("the value should be replaced")
+			int *valueOut;
+			hashmap_get(map, "somekey", (void **)&valueOut);
+			SHOULD_INT_EQUAL(*valueOut, value2);
+		AND("the length should not change")
+			SHOULD_INT_EQUAL(hashmap_length(map), 1);
+
+		hashmap_free(map);
+	SCENARIO_END
+
+	SCENARIO("Put many values")
+		GIVEN("a new hashmap")
+			map_t map = hashmap_new();
+
+		WHEN("I put enough values to grow it several times")
+			int values[1000];
+			char key[32];
+			for (int i = 0; i < 1000; i++)
+			{
+				values[i] = i;
+				sprintf(key, "key%d", i);
+				hashmap_put(map, key, &values[i]);
+			}
+
+		THEN("all the values should be retrievable")
+			int found = 0;
+			for (int i = 0; i < 1000; i++)
+			{
+				int *valueOut;
+				sprintf(key, "key%d", i);
+				if (hashmap_get(map, key, (void **)&valueOut) == MAP_OK &&
+					*valueOut == i)
+				{
+					found++;
+				}
+			}
+			SHOULD_INT_EQUAL(found, 1000);
+			SHOULD_INT_EQUAL(hashmap_length(map), 1000);
+
+		hashmap_free(map);
+	SCENARIO_END
 FEATURE_END
 
 FEATURE(hashmap_get, "Hashmap get")
@@ -73,6 +126,48 @@ FEATURE(hashmap_remove, "Hashmap remove")
 
 		THEN("the operation should be successful")
 			SHOULD_INT_EQUAL(error, (int)MAP_OK);
+		AND("the value should be missing")
+			SHOULD_INT_EQUAL(
+				hashmap_get(map, "somekey", NULL), (int)MAP_MISSING);
+
+		hashmap_free(map);
+	SCENARIO_END
+
+	SCENARIO("Remove a value among many")
+		GIVEN("a hashmap with many values")
+			map_t map = hashmap_new();
+			int value = 42;
+			char key[32];
+			for (int i = 0; i < 100; i++)
+			{
+				sprintf(key, "key%d", i);
+				hashmap_put(map, key, &value);
+			}
+
+		WHEN("I remove every other value")
+			for (int i = 0; i < 100; i += 2)
+			{
+				sprintf(key, "key%d", i);
+				hashmap_remove(map, key);
+			}
+
+		THEN("only the remaining values should be found")
+			int found = 0;
+			int foundRemoved = 0;
+			for (int i = 0; i < 100; i++)
+			{
+				sprintf(key, "key%d", i);
+				if (hashmap_get(map, key, NULL) == MAP_OK)
+				{
+					if (i % 2 == 0)
+						foundRemoved++;
+					else
+						found++;
+				}
+			}
+			SHOULD_INT_EQUAL(found, 50);
+			SHOULD_INT_EQUAL(foundRemoved, 0);
+			SHOULD_INT_EQUAL(hashmap_length(map), 50);
 
 		hashmap_free(map);
 	SCENARIO_END
@@ -85,6 +180,31 @@ static int copy_key(any_t data, any_t key)
     *keys = strdup(key);
     return MAP_OK;
 }
+FEATURE(hashmap_iterate_keys, "Hashmap iterate keys")
+	SCENARIO("Iterate a hashmap by keys")
+		GIVEN("a hashmap with keys c, a, b")
+			map_t map = hashmap_new();
+			int value = 42;
+			hashmap_put(map, "c", &value);
+			hashmap_put(map, "a", &value);
+			hashmap_put(map, "b", &value);
+
+		WHEN("I iterate it by keys")
+			char *keys[3];
+			memset(keys, 0, sizeof keys);
+			const int error = hashmap_iterate_keys(map, copy_key, keys);
+
+		THEN("the keys should be in insertion order")
+			SHOULD_INT_EQUAL(error, MAP_OK);
+			SHOULD_STR_EQUAL(keys[0], "c");
+			SHOULD_STR_EQUAL(keys[1], "a");
+			SHOULD_STR_EQUAL(keys[2], "b");
+
+		for (int i = 0; i < 3; i++) free(keys[i]);
+		hashmap_free(map);
+	SCENARIO_END
+FEATURE_END
+
 FEATURE(hashmap_iterate_keys_sorted, "Hashmap iterate keys sorted")
     SCENARIO("Iterate a hashmap sorted by keys")
         GIVEN("a hashmap with keys a, b, c")
@@ -117,5 +237,6 @@ CBEHAVE_RUN(
 	TEST_FEATURE(hashmap_put),
 	TEST_FEATURE(hashmap_get),
 	TEST_FEATURE(hashmap_remove),
+	TEST_FEATURE(hashmap_iterate_keys),
     TEST_FEATURE(hashmap_iterate_keys_sorted)
 )
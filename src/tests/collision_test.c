@@ -0,0 +1,213 @@
+#define SDL_MAIN_HANDLED 1
+#include <cbehave/cbehave.h>
+
+#include <stdlib.h>
+
+#include <collision/collision.h>
+#include <collision/minkowski_hex.h>
+#include <map.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+#define MAP_W 32
+#define MAP_H 32
+#define NUM_RAYS 20000
+
+static bool sWalls[MAP_H][MAP_W];
+static bool IsWall(const struct vec2i tv)
+{
+	return sWalls[tv.y][tv.x];
+}
+static void SetupWalls(const int percent)
+{
+	memset(sWalls, 0, sizeof sWalls);
+	gMap.Size = svec2i(MAP_W, MAP_H);
+	for (int y = 0; y < MAP_H; y++)
+	{
+		for (int x = 0; x < MAP_W; x++)
+		{
+			sWalls[y][x] = rand() % 100 < percent;
+		}
+	}
+}
+
+// Reference: test every wall tile around the motion, as OverlapThings does,
+// taking the closest hit and breaking ties in y/x order
+static bool RaycastWallsReference(
+	const struct vec2 pos, const struct vec2 vel, struct vec2 *col,
+	struct vec2 *normal)
+{
+	const struct vec2 end = svec2_add(pos, vel);
+	const int x0 = MAX((int)(MIN(pos.x, end.x) / TILE_WIDTH) - 1, 0);
+	const int y0 = MAX((int)(MIN(pos.y, end.y) / TILE_HEIGHT) - 1, 0);
+	const int x1 = MIN((int)(MAX(pos.x, end.x) / TILE_WIDTH) + 1, MAP_W - 1);
+	const int y1 = MIN((int)(MAX(pos.y, end.y) / TILE_HEIGHT) + 1, MAP_H - 1);
+	bool hit = false;
+	float best = 0;
+	for (int y = y0; y <= y1; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+		{
+			struct vec2 colA, colB, n;
+			if (!sWalls[y][x] ||
+				!MinkowskiHexCollide(
+					pos, vel, svec2i_zero(), Vec2CenterOfTile(svec2i(x, y)),
+					svec2_zero(), TILE_SIZE, &colA, &colB, &n))
+			{
+				continue;
+			}
+			const float d2 = svec2_distance_squared(colA, pos);
+			if (!hit || d2 < best)
+			{
+				hit = true;
+				best = d2;
+				*col = colA;
+				*normal = n;
+			}
+		}
+	}
+	return hit;
+}
+
+static float RandRange(const float lo, const float hi)
+{
+	return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+// Random motion, often starting on or moving along tile edges, which are
+// the special cases of the traversal
+static void RandomRay(const int i, struct vec2 *pos, struct vec2 *vel)
+{
+	*pos = svec2(
+		RandRange(TILE_WIDTH, (MAP_W - 1) * TILE_WIDTH),
+		RandRange(TILE_HEIGHT, (MAP_H - 1) * TILE_HEIGHT));
+	const float len = RandRange(0, i % 7 == 0 ? 300.0f : 30.0f);
+	const float angle = RandRange(0, 2 * (float)M_PI);
+	*vel = svec2(cosf(angle) * len, sinf(angle) * len);
+	switch (i % 4)
+	{
+	case 1:
+		// Integer positions and velocities pass through corners exactly
+		*pos = svec2(floorf(pos->x), floorf(pos->y));
+		*vel = svec2(floorf(vel->x), floorf(vel->y));
+		break;
+	case 2:
+		// Start on a vertical tile edge, moving along it half the time
+		pos->x = floorf(pos->x / TILE_WIDTH) * TILE_WIDTH;
+		if (i % 8 == 2)
+		{
+			vel->x = 0;
+		}
+		break;
+	case 3:
+		// Start on a horizontal tile edge, moving along it half the time
+		pos->y = floorf(pos->y / TILE_HEIGHT) * TILE_HEIGHT;
+		if (i % 8 == 3)
+		{
+			vel->y = 0;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+FEATURE(raycast_walls, "Raycast walls")
+	SCENARIO("Start inside a wall")
+		GIVEN("a single wall tile")
+			SetupWalls(0);
+			sWalls[1][1] = true;
+
+		WHEN("I raycast from inside it")
+			struct vec2i tile;
+			struct vec2 col, normal;
+			const bool hit = RaycastWalls(
+				svec2(20, 18), svec2(30, 0), IsWall, &tile, &col, &normal);
+
+		THEN("the wall should be hit at the start with no normal")
+			SHOULD_BE_TRUE(hit);
+			SHOULD_INT_EQUAL(tile.x, 1);
+			SHOULD_INT_EQUAL(tile.y, 1);
+			SHOULD_BE_TRUE(svec2_is_equal(col, svec2(20, 18)));
+			SHOULD_BE_TRUE(svec2_is_zero(normal));
+	SCENARIO_END
+
+	SCENARIO("Pass through the corner of a wall")
+		GIVEN("a single wall tile")
+			SetupWalls(0);
+			sWalls[1][0] = true;
+
+		WHEN("I raycast diagonally through its top right corner")
+			struct vec2i tile;
+			struct vec2 col, normal;
+			const bool hit = RaycastWalls(
+				svec2(8, 6), svec2(16, 12), IsWall, &tile, &col, &normal);
+
+		THEN("the wall should be hit at the corner")
+			SHOULD_BE_TRUE(hit);
+			SHOULD_INT_EQUAL(tile.x, 0);
+			SHOULD_INT_EQUAL(tile.y, 1);
+			SHOULD_BE_TRUE(svec2_is_equal(col, svec2(16, 12)));
+	SCENARIO_END
+
+	SCENARIO("Move along the edge of a wall")
+		GIVEN("a single wall tile")
+			SetupWalls(0);
+			sWalls[0][1] = true;
+
+		WHEN("I raycast along its bottom edge")
+			struct vec2i tile;
+			struct vec2 col, normal;
+			const bool hit = RaycastWalls(
+				svec2(4, 12), svec2(36, 0), IsWall, &tile, &col, &normal);
+
+		THEN("the wall should be hit where the edge starts")
+			SHOULD_BE_TRUE(hit);
+			SHOULD_INT_EQUAL(tile.x, 1);
+			SHOULD_INT_EQUAL(tile.y, 0);
+			SHOULD_BE_TRUE(svec2_is_equal(col, svec2(16, 12)));
+	SCENARIO_END
+
+	SCENARIO("Match testing every wall tile")
+		GIVEN("maps with random walls")
+			srand(3);
+
+		WHEN("I raycast many random rays")
+			int hits = 0;
+			int mismatches = 0;
+			for (int i = 0; i < NUM_RAYS; i++)
+			{
+				if (i % 1000 == 0)
+				{
+					SetupWalls(5 + (i / 1000) % 4 * 10);
+				}
+				struct vec2 pos, vel;
+				RandomRay(i, &pos, &vel);
+				struct vec2i tile;
+				struct vec2 col, normal, refCol, refNormal;
+				const bool hit =
+					RaycastWalls(pos, vel, IsWall, &tile, &col, &normal);
+				const bool refHit =
+					RaycastWallsReference(pos, vel, &refCol, &refNormal);
+				if (hit != refHit ||
+					(hit && (!svec2_is_equal(col, refCol) ||
+							 !svec2_is_equal(normal, refNormal))))
+				{
+					mismatches++;
+				}
+				hits += refHit ? 1 : 0;
+			}
+
+		THEN("the hits, positions and normals should all match")
+			SHOULD_INT_EQUAL(mismatches, 0);
+		AND("a good number of rays should hit walls")
+			SHOULD_INT_GT(hits, NUM_RAYS / 4);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Collision features are:", TEST_FEATURE(raycast_walls))
@@ -0,0 +1,104 @@
+// Benchmark for config reads; not run as part of the test suite.
+// Compares reading a value by name, as the hot paths used to, with reading
+// it through a ConfigHandle, in time and in allocations per frame.
+// config.c is built into this benchmark with CDOGS_COUNT_ALLOCS so that its
+// CMALLOC/CFREE calls are counted.
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <time.h>
+
+#include <config.h>
+#include <pic_manager.h>
+#include <sounds.h>
+#include <weapon.h>
+
+#define NUM_FRAMES 10000
+// Reads per frame made by the hot paths, e.g. fog, shadows, sight range
+#define READS_PER_FRAME 64
+
+int gAllocCount = 0;
+int gFreeCount = 0;
+
+// Stubs
+Mix_Chunk *StrSound(const char *s)
+{
+	UNUSED(s);
+	return NULL;
+}
+uint32_t StrSoundId(const char *s)
+{
+	UNUSED(s);
+	return 0;
+}
+uint32_t SoundHandleId(SoundHandle *h)
+{
+	UNUSED(h);
+	return 0;
+}
+Pic *PicManagerGetPic(const PicManager *pm, const char *name)
+{
+	UNUSED(pm);
+	UNUSED(name);
+	return NULL;
+}
+Pic *PicHandleGet(PicHandle *h)
+{
+	UNUSED(h);
+	return NULL;
+}
+const WeaponClass *StrWeaponClass(const char *s)
+{
+	UNUSED(s);
+	return NULL;
+}
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+PicManager gPicManager;
+
+int main(void)
+{
+	gConfig = ConfigDefault();
+	ConfigHandle h = CONFIG_HANDLE("Game.SightRange");
+
+	int sum1 = 0, sum2 = 0;
+	int allocs = gAllocCount, frees = gFreeCount;
+	clock_t start = clock();
+	for (int i = 0; i < NUM_FRAMES; i++)
+	{
+		for (int j = 0; j < READS_PER_FRAME; j++)
+		{
+			sum1 += ConfigGetInt(&gConfig, "Game.SightRange");
+		}
+	}
+	const clock_t byName = clock() - start;
+	const int byNameAllocs = gAllocCount - allocs;
+	const int byNameFrees = gFreeCount - frees;
+	allocs = gAllocCount;
+	frees = gFreeCount;
+	start = clock();
+	for (int i = 0; i < NUM_FRAMES; i++)
+	{
+		for (int j = 0; j < READS_PER_FRAME; j++)
+		{
+			sum2 += ConfigHandleInt(&h);
+		}
+	}
+	const clock_t byHandle = clock() - start;
+	const int byHandleAllocs = gAllocCount - allocs;
+	const int byHandleFrees = gFreeCount - frees;
+
+	const double ns = 1e9 / CLOCKS_PER_SEC / NUM_FRAMES / READS_PER_FRAME;
+	printf(
+		"by name:   %6.1f ns/read, %d mallocs/frame, %d frees/frame\n",
+		byName * ns, byNameAllocs / NUM_FRAMES, byNameFrees / NUM_FRAMES);
+	printf(
+		"by handle: %6.1f ns/read, %d mallocs/frame, %d frees/frame\n",
+		byHandle * ns, byHandleAllocs / NUM_FRAMES,
+		byHandleFrees / NUM_FRAMES);
+	printf("(checksum %d)\n", sum1 - sum2);
+	ConfigDestroy(&gConfig);
+	return 0;
+}
@@ -14,12 +14,27 @@ Mix_Chunk *StrSound(const char *s)
 	UNUSED(s);
 	return NULL;
 }
+uint32_t StrSoundId(const char *s)
+{
+	UNUSED(s);
+	return 0;
+}
+uint32_t SoundHandleId(SoundHandle *h)
+{
+	UNUSED(h);
+	return 0;
+}
 Pic *PicManagerGetPic(const PicManager *pm, const char *name)
 {
 	UNUSED(pm);
 	UNUSED(name);
 	return NULL;
 }
+Pic *PicHandleGet(PicHandle *h)
+{
+	UNUSED(h);
+	return NULL;
+}
 const WeaponClass *StrWeaponClass(const char *s)
 {
 	UNUSED(s);
@@ -121,10 +136,58 @@ FEATURE(save_as_latest, "Save config as latest format by default")
 	SCENARIO_END
 FEATURE_END
 
+FEATURE(config_handles, "Config handles")
+	SCENARIO("Read config through a handle")
+		GIVEN("a default config and a handle to one of its values")
+			gConfig = ConfigDefault();
+			ConfigHandle h = CONFIG_HANDLE("Game.Fog");
+			ConfigGet(&gConfig, "Game.Fog")->u.Bool.Value = true;
+
+		WHEN("I read the handle, then change the value directly")
+			const bool before = ConfigHandleBool(&h);
+			const Config *resolved = h.c;
+			ConfigGet(&gConfig, "Game.Fog")->u.Bool.Value = false;
+
+		THEN("the handle should see the new value without a new lookup")
+			SHOULD_BE_TRUE(before);
+			SHOULD_BE_FALSE(ConfigHandleBool(&h));
+			SHOULD_BE_TRUE(h.c == resolved);
+		AND("the handle should be resolved again after invalidation")
+			const int generation = h.generation;
+			ConfigHandlesInvalidate();
+			ConfigHandleBool(&h);
+			SHOULD_BE_TRUE(h.generation != generation);
+			ConfigDestroy(&gConfig);
+	SCENARIO_END
+
+	SCENARIO("Read a handle repeatedly")
+		GIVEN("a default config and a resolved handle")
+			gConfig = ConfigDefault();
+			ConfigHandle h = CONFIG_HANDLE("Game.SightRange");
+			ConfigHandleInt(&h);
+			const int generation = h.generation;
+
+		WHEN("I read the value many times by name and by handle")
+			int sum1 = 0, sum2 = 0;
+			for (int i = 0; i < 100; i++)
+			{
+				sum1 += ConfigGetInt(&gConfig, "Game.SightRange");
+				sum2 += ConfigHandleInt(&h);
+			}
+
+		THEN("both should read the same values")
+			SHOULD_INT_EQUAL(sum1, sum2);
+		AND("the handle should not have looked up the name again")
+			SHOULD_INT_EQUAL(h.generation, generation);
+			ConfigDestroy(&gConfig);
+	SCENARIO_END
+FEATURE_END
+
 CBEHAVE_RUN(
 	"Config features are:",
 	TEST_FEATURE(load_default),
 	TEST_FEATURE(save_and_load),
 	TEST_FEATURE(detect_version),
-	TEST_FEATURE(save_as_latest)
+	TEST_FEATURE(save_as_latest),
+	TEST_FEATURE(config_handles)
 )
@@ -0,0 +1,114 @@
+#define SDL_MAIN_HANDLED
+#include <cbehave/cbehave.h>
+
+#include <draw/draw_buffer.h>
+
+#include <stdlib.h>
+
+
+#define NUM_THINGS 200
+#define NUM_COMMANDS 2000
+
+// Reference order: stable insertion sort by key
+static void SortReference(CArray *commands)
+{
+	for (int i = 1; i < (int)commands->size; i++)
+	{
+		DrawCommand c = *(DrawCommand *)CArrayGet(commands, i);
+		int j = i - 1;
+		for (; j >= 0 && ((DrawCommand *)CArrayGet(commands, j))->Key > c.Key;
+			 j--)
+		{
+			CArraySet(commands, j + 1, CArrayGet(commands, j));
+		}
+		CArraySet(commands, j + 1, &c);
+	}
+}
+
+FEATURE(draw_order, "Draw command order")
+	SCENARIO("Tiles then things by y, per layer and row")
+		GIVEN("commands added in tile order")
+			DrawBuffer b;
+			DrawBufferInit(&b, svec2i(4, 4), NULL);
+			Thing things[3];
+			memset(things, 0, sizeof things);
+			things[0].Pos.y = 20.5f;
+			things[1].Pos.y = 18.f;
+			things[2].Pos.y = 2.f;
+			const struct vec2i pos = svec2i_zero();
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_WALLS_AND_THINGS, 1, NULL, &things[0], pos,
+				true);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_WALLS_AND_THINGS, 1, NULL, NULL, pos, false);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_WALLS_AND_THINGS, 1, NULL, &things[1], pos,
+				true);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_WALLS_AND_THINGS, 0, NULL, &things[2], pos,
+				true);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_FLOOR, 1, NULL, NULL, pos, false);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_CHATTERS, 0, NULL, &things[1], pos, false);
+			DrawBufferAddCommand(
+				&b, DRAW_LAYER_CHATTERS, 0, NULL, &things[0], pos, false);
+
+		WHEN("I sort them")
+			DrawBufferSortCommands(&b);
+
+		THEN("they should be in draw order")
+			const DrawCommand *c = b.commands.data;
+			SHOULD_INT_EQUAL(c[0].Layer, DRAW_LAYER_FLOOR);
+			SHOULD_BE_TRUE(c[1].Thing == &things[2]);
+			SHOULD_BE_TRUE(c[2].Thing == NULL);
+			SHOULD_BE_TRUE(c[3].Thing == &things[1]);
+			SHOULD_BE_TRUE(c[4].Thing == &things[0]);
+			SHOULD_BE_TRUE(c[5].Thing == &things[1]);
+			SHOULD_BE_TRUE(c[6].Thing == &things[0]);
+			DrawBufferTerminate(&b);
+	SCENARIO_END
+
+	SCENARIO("Same order as a stable sort")
+		GIVEN("many random commands")
+			DrawBuffer b;
+			DrawBufferInit(&b, svec2i(32, 32), NULL);
+			Thing things[NUM_THINGS];
+			memset(things, 0, sizeof things);
+			srand(1);
+			for (int i = 0; i < NUM_THINGS; i++)
+			{
+				// Include duplicate y values
+				things[i].Pos.y = (float)(rand() % 64) / 4.0f;
+			}
+			for (int i = 0; i < NUM_COMMANDS; i++)
+			{
+				const DrawLayer layer =
+					(DrawLayer)(rand() % (DRAW_LAYER_PICKUP_MENUS + 1));
+				const bool sortY = rand() % 2;
+				DrawBufferAddCommand(
+					&b, layer, rand() % 20, NULL,
+					&things[rand() % NUM_THINGS], svec2i(i, 0), sortY);
+			}
+			CArray expected;
+			CArrayInit(&expected, sizeof(DrawCommand));
+			CArrayCopy(&expected, &b.commands);
+
+		WHEN("I sort them, and sort a copy with a reference stable sort")
+			DrawBufferSortCommands(&b);
+			SortReference(&expected);
+
+		THEN("the orders should be identical")
+			SHOULD_INT_EQUAL((int)b.commands.size, (int)expected.size);
+			for (int i = 0; i < (int)expected.size; i++)
+			{
+				const DrawCommand *c1 = CArrayGet(&b.commands, i);
+				const DrawCommand *c2 = CArrayGet(&expected, i);
+				SHOULD_INT_EQUAL(c1->Pos.x, c2->Pos.x);
+			}
+			CArrayTerminate(&expected);
+			DrawBufferTerminate(&b);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN("Draw buffer features are:", TEST_FEATURE(draw_order))
@@ -34,6 +34,17 @@ bool ConfigIsOld(FILE *f)
 	return false;
 }
 int PicManagerGetPic(void) { return 0; }
+int PicHandleGet(void) { return 0; }
+uint32_t StrSoundId(const char *s)
+{
+	UNUSED(s);
+	return 0;
+}
+uint32_t SoundHandleId(SoundHandle *h)
+{
+	UNUSED(h);
+	return 0;
+}
 int StrWeaponClass(void) { return 0; }
 int gPicManager;
 
@@ -0,0 +1,67 @@
+// Benchmark for cave generation; not run as part of the test suite.
+// Times the cellular automaton and area labelling over a range of map sizes
+// and fill percentages, to show that both scale linearly with map area.
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <map_cave.h>
+
+#define NUM_REPEATS 20
+// Defaults for new cave missions
+#define CAVE_REPEAT 4
+#define CAVE_R1 5
+#define CAVE_R2 2
+
+int main(void)
+{
+	static const int sizes[] = {32, 64, 128, 256, 512};
+	static const int fills[] = {30, 40, 50, 60};
+	srand(1);
+	printf("%6s %5s %13s %13s %8s\n", "size", "fill", "step ns/tile",
+		   "label ns/tile", "areas");
+	for (int s = 0; s < (int)(sizeof sizes / sizeof sizes[0]); s++)
+	{
+		const struct vec2i size = svec2i(sizes[s], sizes[s]);
+		const double tiles = (double)size.x * size.y * NUM_REPEATS;
+		int *labels = malloc(size.x * size.y * sizeof *labels);
+		for (int f = 0; f < (int)(sizeof fills / sizeof fills[0]); f++)
+		{
+			double stepTime = 0, labelTime = 0;
+			int numAreas = 0;
+			for (int r = 0; r < NUM_REPEATS; r++)
+			{
+				CaveBitmap bitmaps[2];
+				CaveBitmapInit(&bitmaps[0], size);
+				CaveBitmapInit(&bitmaps[1], size);
+				RECT_FOREACH(Rect2iNew(svec2i_zero(), size))
+				CaveBitmapSet(&bitmaps[0], _v, rand() % 100 < fills[f]);
+				RECT_FOREACH_END()
+
+				clock_t start = clock();
+				int cur = 0;
+				for (int i = 0; i < CAVE_REPEAT; i++)
+				{
+					CaveBitmapStep(
+						&bitmaps[cur], &bitmaps[1 - cur], CAVE_R1, CAVE_R2);
+					cur = 1 - cur;
+				}
+				stepTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+				start = clock();
+				numAreas += CaveBitmapLabelAreas(&bitmaps[cur], labels);
+				labelTime += (double)(clock() - start) / CLOCKS_PER_SEC;
+
+				CaveBitmapTerminate(&bitmaps[0]);
+				CaveBitmapTerminate(&bitmaps[1]);
+			}
+			printf(
+				"%6d %4d%% %13.2f %13.2f %8d\n", sizes[s], fills[f],
+				stepTime * 1e9 / tiles / CAVE_REPEAT,
+				labelTime * 1e9 / tiles, numAreas / NUM_REPEATS);
+		}
+		free(labels);
+	}
+	return 0;
+}
@@ -0,0 +1,153 @@
+#define SDL_MAIN_HANDLED 1
+#include <cbehave/cbehave.h>
+
+#include <map_cave.h>
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+// Own generator, so that maps and checksums don't depend on the C library
+static uint32_t sSeed;
+static int NextRand(void)
+{
+	sSeed = sSeed * 1103515245u + 12345u;
+	return (int)((sSeed >> 16) & 0x7fff);
+}
+
+static void FillRandom(
+	CaveBitmap *b, bool *ref, const struct vec2i size, const uint32_t seed,
+	const int fillPercent)
+{
+	sSeed = seed;
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), size))
+	const bool wall = NextRand() % 100 < fillPercent;
+	CaveBitmapSet(b, _v, wall);
+	ref[_i] = wall;
+	RECT_FOREACH_END()
+}
+
+// The per-tile automaton step used before the bitmaps: count walls within
+// distance d, including the tile itself, with the map edge counting as wall
+static int CountWallsAroundRef(
+	const bool *ref, const struct vec2i size, const struct vec2i pos,
+	const int d)
+{
+	int c = 0;
+	RECT_FOREACH(Rect2iNew(
+		svec2i_subtract(pos, svec2i(d, d)), svec2i(2 * d + 1, 2 * d + 1)))
+	if (!Rect2iIsInside(Rect2iNew(svec2i_zero(), size), _v) ||
+		ref[_v.y * size.x + _v.x])
+	{
+		c++;
+	}
+	RECT_FOREACH_END()
+	return c;
+}
+static void CaveRepRef(
+	bool *ref, const struct vec2i size, const int r1, const int r2)
+{
+	bool *buf;
+	CMALLOC(buf, size.x * size.y * sizeof *buf);
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), size))
+	buf[_i] = CountWallsAroundRef(ref, size, _v, 1) >= r1 ||
+			  CountWallsAroundRef(ref, size, _v, 2) <= r2;
+	RECT_FOREACH_END()
+	memcpy(ref, buf, size.x * size.y * sizeof *buf);
+	CFREE(buf);
+}
+
+// Run the automaton on bitmaps and on the reference grid;
+// returns the number of tiles that differ
+static int CompareWithRef(
+	const struct vec2i size, const uint32_t seed, const int fillPercent,
+	const int repeat, const int r1, const int r2, uint32_t *checksum)
+{
+	CaveBitmap bitmaps[2];
+	CaveBitmapInit(&bitmaps[0], size);
+	CaveBitmapInit(&bitmaps[1], size);
+	bool *ref;
+	CMALLOC(ref, size.x * size.y * sizeof *ref);
+	FillRandom(&bitmaps[0], ref, size, seed, fillPercent);
+
+	int cur = 0;
+	for (int i = 0; i < repeat; i++)
+	{
+		CaveBitmapStep(&bitmaps[cur], &bitmaps[1 - cur], r1, r2);
+		cur = 1 - cur;
+		CaveRepRef(ref, size, r1, r2);
+	}
+
+	int diffs = 0;
+	// FNV-1a over the tiles in row order, 1 for wall
+	*checksum = 2166136261u;
+	RECT_FOREACH(Rect2iNew(svec2i_zero(), size))
+	const bool wall = CaveBitmapGet(&bitmaps[cur], _v);
+	if (wall != ref[_i])
+	{
+		diffs++;
+	}
+	*checksum = (*checksum ^ (uint8_t)wall) * 16777619u;
+	RECT_FOREACH_END()
+
+	CFREE(ref);
+	CaveBitmapTerminate(&bitmaps[0]);
+	CaveBitmapTerminate(&bitmaps[1]);
+	return diffs;
+}
+
+FEATURE(CaveBitmapStep, "Cave cellular automaton")
+	SCENARIO("Same output as the per-tile algorithm")
+		GIVEN("maps of various sizes, fills and rules")
+			// Widths either side of the 64-bit word boundaries
+			static const int widths[] = {1, 5, 31, 59, 60, 64, 65, 127, 130};
+			static const int fills[] = {0, 35, 50, 100};
+			static const int rules[][2] = {{5, 2}, {5, -1}, {4, 3}, {10, 0}};
+
+		WHEN("I run the automaton on bitmaps and on tiles")
+			int diffs = 0;
+			uint32_t seed = 1;
+			for (int w = 0; w < (int)(sizeof widths / sizeof widths[0]); w++)
+			{
+				for (int f = 0; f < (int)(sizeof fills / sizeof fills[0]); f++)
+				{
+					for (int r = 0; r < (int)(sizeof rules / sizeof rules[0]);
+						 r++)
+					{
+						uint32_t checksum;
+						diffs += CompareWithRef(
+							svec2i(widths[w], 37), seed++, fills[f], 4,
+							rules[r][0], rules[r][1], &checksum);
+					}
+				}
+			}
+
+		THEN("every tile should be the same")
+			SHOULD_INT_EQUAL(diffs, 0);
+	SCENARIO_END
+
+	SCENARIO("Fixed seed")
+		GIVEN("a map with a fixed seed and the default cave settings")
+			const struct vec2i size = svec2i(64, 64);
+			const uint32_t seed = 12345;
+
+		WHEN("I run the automaton")
+			uint32_t checksum;
+			const int diffs =
+				CompareWithRef(size, seed, 40, 4, 5, 2, &checksum);
+
+		THEN("the output should match the per-tile algorithm")
+			SHOULD_INT_EQUAL(diffs, 0);
+		AND("the output should match the stored checksum")
+			// Output of the per-tile algorithm before the bitmaps
+			SHOULD_BE_TRUE(checksum == 0x5b30b9d1u);
+	SCENARIO_END
+FEATURE_END
+
+CBEHAVE_RUN(
+	"Map cave features are:",
+	TEST_FEATURE(CaveBitmapStep)
+)
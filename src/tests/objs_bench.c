@@ -0,0 +1,112 @@
+// Benchmark for map object updates; not run as part of the test suite.
+// Compares the tick time of UpdateObjects, which only visits awake objects,
+// with the loop it replaced, which updated every object in use. Dense
+// classic missions place hundreds of barrels, boxes and furniture, almost
+// all of which sit idle.
+#define SDL_MAIN_HANDLED
+#include <stdio.h>
+#include <time.h>
+
+#include <objs.h>
+
+#define NUM_TICKS 10000
+
+// Stubs
+const char *JoyName(const int deviceIndex)
+{
+	UNUSED(deviceIndex);
+	return NULL;
+}
+
+// The loop UpdateObjects used before objects could sleep; for normal
+// objects it updated the thing and checked whether to emit smoke
+static void UpdateAllObjects(const int ticks)
+{
+	CA_FOREACH(TObject, obj, gObjs)
+	if (!obj->isInUse)
+	{
+		continue;
+	}
+	ThingUpdate(&obj->thing, ticks);
+	if (obj->Class->DamageSmoke.HealthThreshold >= 0 &&
+		obj->Health <=
+			obj->Class->Health * obj->Class->DamageSmoke.HealthThreshold)
+	{
+		obj->counter++;
+	}
+	CA_FOREACH_END()
+}
+
+// Add objects directly, as ObjAdd would without placing them on the map.
+// Busy objects are given a long sound lock so they stay awake.
+static void AddObjects(
+	const MapObject *mo, const int count, const int busyPercent)
+{
+	for (int i = 0; i < count; i++)
+	{
+		TObject o;
+		memset(&o, 0, sizeof o);
+		o.uid = i;
+		o.Class = mo;
+		o.Health = mo->Health;
+		o.counter = -1;
+		o.thing.id = i;
+		o.thing.kind = KIND_OBJECT;
+		o.thing.CPic.Type = PICTYPE_NORMAL;
+		if (i * 100 < count * busyPercent)
+		{
+			o.thing.SoundLock = NUM_TICKS * 2;
+		}
+		o.isInUse = true;
+		CArrayPushBack(&gObjs, &o);
+		ObjWake(CArrayGet(&gObjs, i));
+	}
+}
+
+int main(void)
+{
+	static const int counts[] = {250, 500, 1000, 2000};
+	static const int busyPercents[] = {0, 5, 20};
+	MapObject mo;
+	memset(&mo, 0, sizeof mo);
+	mo.Type = MAP_OBJECT_TYPE_NORMAL;
+	mo.Health = 40;
+	mo.DamageSmoke.HealthThreshold = 0.5f;
+
+	printf(
+		"%7s %5s %15s %14s\n", "objects", "busy", "before ns/tick",
+		"after ns/tick");
+	for (int c = 0; c < (int)(sizeof counts / sizeof counts[0]); c++)
+	{
+		for (int b = 0; b < (int)(sizeof busyPercents / sizeof busyPercents[0]);
+			 b++)
+		{
+			ObjsInit();
+			AddObjects(&mo, counts[c], busyPercents[b]);
+
+			clock_t start = clock();
+			for (int i = 0; i < NUM_TICKS; i++)
+			{
+				UpdateAllObjects(1);
+			}
+			const clock_t before = clock() - start;
+			start = clock();
+			for (int i = 0; i < NUM_TICKS; i++)
+			{
+				UpdateObjects(1);
+			}
+			const clock_t after = clock() - start;
+
+			const double ns = 1e9 / CLOCKS_PER_SEC / NUM_TICKS;
+			printf(
+				"%7d %4d%% %15.1f %14.1f\n", counts[c], busyPercents[b],
+				before * ns, after * ns);
+			// The objects aren't on the map, so don't destroy them
+			CA_FOREACH(TObject, o, gObjs)
+			o->isInUse = false;
+			CA_FOREACH_END()
+			ObjsTerminate();
+		}
+	}
+	return 0;
+}